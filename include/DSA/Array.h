@@ -14,10 +14,7 @@
 #include <cstring> // memcpy
 #include <DSA/DSA.h>
 #include <DSA/ClassID.h>
-namespace DSA
-{
-	class Stream;
-}
+#include <DSA/Stream.h>
 //#pragma
 namespace DSA
 {
@@ -306,6 +303,9 @@ namespace DSA
 		// Run-time Stream I/O
 		DSA_Export bool put(      Stream& stream, UChar ver) const;
 		DSA_Export bool get(const Stream& stream, UChar ver);
+		// Load in place: the array refers to the payload in a Memory or Mapped stream
+		// (see Stream.h); a file stream is read as by get().
+		DSA_Export bool map(const Stream& stream);
 		// ============================================================
 	};
 
@@ -72,9 +72,9 @@ namespace DSA
 	template<class T>
 	void Array<T>::swap(Array<T>& src)
 	{
-		m_data = src.m_data;
-		m_len  = src.m_len;
-		m_space= src.m_space;
+		T*  data  = src.m_data;  src.m_data  = m_data;  m_data  = data;
+		int len   = src.m_len;   src.m_len   = m_len;   m_len   = len;
+		int space = src.m_space; src.m_space = m_space; m_space = space;
 	}
 
 	// Copy-construct an array from a C-style array
@@ -320,6 +320,47 @@ namespace DSA
 		}
 	}
 
+	// Bulk binary I/O: one ArrayHeader and the elements in one write (see Stream.h)
+	template<class T>
+	bool Array<T>::put(Stream& stream, UChar /*ver*/) const
+	{
+		return putArray<IDClass>(stream, m_data, m_len, 1, &m_len, m_len);
+	}
+
+	template<class T>
+	bool Array<T>::get(const Stream& stream, UChar /*ver*/)
+	{
+		ArrayHeader h;
+		if( ! getArrayHeader<IDClass,T>(stream, h, 1) || ! alloc((int)h.count) )
+			return false;
+		return stream.read(m_data, (size_t)h.count*sizeof(T));
+	}
+
+	template<class T>
+	bool Array<T>::map(const Stream& stream)
+	{
+		ArrayHeader h;
+		if( ! getArrayHeader<IDClass,T>(stream, h, 1) )
+			return false;
+		T* p = (T*)stream.view((size_t)h.count*sizeof(T));
+		if( p == 0 ) // File stream, or an empty record
+			return alloc((int)h.count) && stream.read(m_data, (size_t)h.count*sizeof(T));
+		redefine(p, (int)h.count, -(int)h.count); // Not owned
+		return true;
+	}
+
+	template<typename T, int SPACE>
+	bool Array<T,SPACE>::put(Stream& stream, UChar ver) const
+	{
+		return Array<T,0>::put(stream, ver);
+	}
+
+	template<typename T, int SPACE>
+	bool Array<T,SPACE>::get(const Stream& stream, UChar ver)
+	{
+		return Array<T,0>::get(stream, ver);
+	}
+
 	template<class T>
 	void Array<T>::getMinMax(T &min, T &max)
 	{
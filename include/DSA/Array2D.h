@@ -12,10 +12,11 @@
 #include <DSA/DSA.h>
 #include <DSA/Array.h>
 #include <DSA/ClassID.h>
-namespace DSA
-{
-	class Stream;
-}
+#include <DSA/Indexer.h>
+#include <DSA/Stream.h>
+#include <DSA/Parallel.h>
+#include <DSA/Reduce.h>
+#include <DSA/ArrayNDView.h>
 //#pragma
 namespace DSA
 {
@@ -39,21 +40,33 @@ namespace DSA
 	// ----------> [x] RowN
 
 
-	template<typename T, int XSPACE=0, int YSPACE=0>
+	// LAYOUT is the storage order: Indexer (row-major, default), MortonIndexer or
+	// TileIndexer (see Indexer.h).
+	template<typename T, int XSPACE=0, int YSPACE=0, template<int> class LAYOUT=Indexer>
 	class Array2D;
 
 	// Array 2D with dynamic storage ===============
+	// Rows are "ld" (leading dimension) elements apart, ld >= cols. The row stride is
+	// chosen by stride() so that each row of a few cache lines or more starts on a
+	// cache line, and rows of a power-of-two width do not alias the same cache sets
+	// in column walks. Narrower rows are packed.
+	// Row 0 is aligned to a cache line; padding elements are never read or written.
 
 	template<class T>
 	class Array2D<T,0,0> : protected Array<T>
 	{
 	protected: // Data Members
+		using Array<T>::m_data;   // Row 0 (cache line aligned)
+		using Array<T>::m_len;    // m_rows*m_ld
+		using Array<T>::m_space;  // -capacity: the block is owned by Array2D, NOT by Array<T>
 		int		m_rows;     // number of rows
 		int		m_cols;     // number of columns
+		int		m_ld;       // leading dimension: elements between row starts (>= m_cols)
+		void*	m_mem;      // raw heap block holding the rows; 0 for a static buffer
 
 	public:
 		// Constructors:
-		Array2D() : m_rows(0), m_cols(0) {};
+		Array2D() : m_rows(0), m_cols(0), m_ld(0), m_mem(0) {};
 		// Default construct an array of given length(=space).
 		Array2D(int nRow, int nCol);
 		// Default construct an array of given space(>len).
@@ -62,63 +75,126 @@ namespace DSA
 		// Copy Construct
 		Array2D(const Array2D<T>& src);
 
+		virtual ~Array2D() { release(); }
+
 		// Copy Assignment
 		Array2D<T>& operator=(const Array2D<T>& src);
 
 		// Assign all current elements from a given value
 		Array2D<T>& operator=(const T& value);
-		//		~Array2D() {if(m_data) delete [] m_data;}
 
 		// (Re)alloc array size, invalidate data, and use existing memory if possible.
 		virtual bool alloc(int newRow, int newCol);
+		// Same as above, with an explicit row stride (ld >= newCol).
+		bool alloc(int newRow, int newCol, int ld);
 
-		// Resize the array to a different size. ALWAYS keep existing contents, and use
-		// existing memory space if possible.
+		// Resize the array to a different size. ALWAYS keep existing contents at their
+		// (i,j), and use existing memory space if possible (moving rows in place).
 		virtual bool resize(int newRow, int newCol);
 		
 		// Access number of rows or columns
 		inline int  rows() const { return m_rows; }
 		inline int  cols() const { return m_cols; }
+		// Row stride (in elements) and reserved space
+		inline int  ld() const    { return m_ld; }
+		inline int  space() const { return abs(m_space); }
+
+		// Automatic row stride for a given number of columns: nCol for rows under 4
+		// cache lines, else rounded up to whole cache lines, plus one more line if the
+		// row size is a multiple of 4KB (or a large power of two), which would map
+		// every row to the same cache set.
+		static int stride(int nCol);
 
 		// Access to given Row (row-major) as i => X|Row; j => Y|Col. 
-		inline T*       operator[](int iRow)              {return m_data+iRow*m_cols;}
-		inline const T* operator[](int iRow) const        {return m_data+iRow*m_cols;}
+		inline T*       operator[](int iRow)              {return m_data+iRow*m_ld;}
+		inline const T* operator[](int iRow) const        {return m_data+iRow*m_ld;}
 
-		inline T&       element(int iRow, int jCol)       {return m_data[iRow*m_cols+jCol];}
-		inline const T& element(int iRow, int jCol) const {return m_data[iRow*m_cols+jCol];}
+		inline T&       element(int iRow, int jCol)       {return m_data[iRow*m_ld+jCol];}
+		inline const T& element(int iRow, int jCol) const {return m_data[iRow*m_ld+jCol];}
 
 		// Return a pointer to the data area as a pointer to the T.
+		// NOTE: rows are ld() apart, NOT cols() apart.
 		T* begin()										  {return m_data;}
 		const T* begin() const							  {return m_data;}
 
-		void getMinMax(T& min, T& max) { Array<T>::getMinMax(min,max); } 
+		// Strided view of the rows x cols elements (strides ld() and 1), e.g. to walk
+		// the array in runs with a RunIterator: one run when ld() == cols().
+		ArrayNDView<T,2> view()
+		{
+			const int d[2] = { m_rows, m_cols }, st[2] = { m_ld, 1 };
+			return ArrayNDView<T,2>(m_data, d, st);
+		}
+		ArrayNDView<const T,2> view() const
+		{
+			const int d[2] = { m_rows, m_cols }, st[2] = { m_ld, 1 };
+			return ArrayNDView<const T,2>(m_data, d, st);
+		}
+
+		// Min and max over all elements (padding excluded). NaNs are skipped.
+		void getMinMax(T& min, T& max) const;
+
+		// Call f(i, row, cols()) on every row. Rows are split across threads when the
+		// array is large, so f must not touch other rows.
+		template<typename Lambda> void applyRows(Lambda f);
+		template<typename Lambda> void applyRows(Lambda f) const; // row is const T*
+
+		// out[i] = OP over row i; OP is a reduction operator (see Reduce.h), e.g.
+		//     a.reduceRows(sums, ReduceSum<float>());
+		template<class OP> bool reduceRows(Array<typename OP::Result>& out, const OP& op = OP()) const;
+		// out[j] = OP over column j. Rows are walked in order, each thread folding its
+		// band of rows into a vector of cols() accumulators; the vectors are merged last.
+		template<class OP> bool reduceCols(Array<typename OP::Result>& out, const OP& op = OP()) const;
 
 		// ========= Common class interfaces  =========================
 		public:
 		typedef DSA::NewClassID<12874,0,ID_DLL> IDClass;
 		typedef Array2D BaseClass;
-		// Run-time Stream I/O
-		DSA_Export bool put(      Stream& stream, UChar ver) const {return true;}
-		DSA_Export bool get(const Stream& stream, UChar ver)       {return true;}
+		// Run-time Stream I/O: the rows*ld() elements (padding included) in one write
+		DSA_Export bool put(      Stream& stream, UChar ver) const;
+		DSA_Export bool get(const Stream& stream, UChar ver);
+		// Load in place: the array refers to the payload in a Memory or Mapped stream
+		// (see Stream.h), keeping the stride it was written with.
+		DSA_Export bool map(const Stream& stream);
 		// ============================================================
+
+	protected:
+		// Allocate an aligned block of given space (default constructed). Old block is released.
+		bool allocBlock(int space);
+		// Destruct and free the owned block
+		void release();
+		// Move (rows x cols) between two strides; the regions may overlap in one block.
+		static void moveRows(T* dst, int ldDst, T* src, int ldSrc, int nRow, int nCol);
+		// Exchange blocks and shapes with another array
+		void swapBlock(Array2D<T>& o);
+		// Copy the overlapping (rows x cols) region from a source layout
+		static void copyRows(T* dst, int ldDst, const T* src, int ldSrc, int nRow, int nCol);
+		// Read a payload of given header into the rows (allocated to its dimensions)
+		bool getRows(const Stream& stream, const ArrayHeader& h);
+		// Dimensions and stride of a header are consistent
+		static bool isValid(const ArrayHeader& h)
+		{
+			return h.ld >= h.dims[1] && h.count == (ULongLong)h.dims[0]*h.ld && h.count <= 0x7FFFFFFF;
+		}
 	};
 
 	// A static Array2D buffer in Cache
 	// NOTE: Never swap Array2DBuf<>
+	// Rows are packed (ld = NCol) in the static buffer.
 	//
 	template<class T, int NRow, int NCol>
-	class Array2D : protected Array2D<T,0,0>
+	class Array2D<T,NRow,NCol,Indexer> : public Array2D<T,0,0>
 	{
 	public:
 		T    data[NRow*NCol]; // Data buffer
 
 		Array2D() : Array2D<T,0,0> ()
 		{
-			m_data  = &data[0];
-			m_len   = NRow * NCol;
-			m_space = -m_len;          // Indicate static buffer
-			m_rows  = NRow;
-			m_cols  = NCol;
+			this->m_data  = &data[0];
+			this->m_len   = NRow * NCol;
+			this->m_space = -this->m_len;    // Indicate static buffer
+			this->m_rows  = NRow;
+			this->m_cols  = NCol;
+			this->m_ld    = NCol;
 		}
 
 		virtual ~Array2D() {}
@@ -127,9 +203,95 @@ namespace DSA
 		public:
 		typedef Array2D<T,0,0> BaseClass;
 		typedef DSA::NewClassID<34664,0,ID_DLL> IDClass;
-		// Run-time Stream I/O
-		DSA_Export bool put(      Stream& stream, UChar ver) const {return true;}
-		DSA_Export bool get(const Stream& stream, UChar ver)       {return true;}
+		// Run-time Stream I/O, in the format of Array2D<T> (get() needs NRow x NCol)
+		DSA_Export bool put(      Stream& stream, UChar ver) const { return BaseClass::put(stream, ver); }
+		DSA_Export bool get(const Stream& stream, UChar ver)
+		{
+			ArrayHeader h;
+			return getArrayHeader<BaseClass::IDClass,T>(stream, h, 2) && this->isValid(h)
+				&& h.dims[0] == NRow && h.dims[1] == NCol && this->getRows(stream, h);
+		}
+		// ============================================================
+	};
+
+	// Array 2D with a blocked storage LAYOUT (MortonIndexer, TileIndexer) ========
+	// Neighbours in both directions share cache lines, and every aligned TILE x TILE
+	// block is contiguous. Rows are NOT contiguous: use element(i,j) or (i,j),
+	// or forEachTile() to hand whole tiles to a kernel.
+	template<class T, template<int> class LAYOUT>
+	class Array2D<T,0,0,LAYOUT> : protected Array2D<T,0,0>
+	{
+	protected:
+		typedef Array2D<T,0,0> Storage; // One aligned row of idx.space() elements
+		using Storage::m_data;
+		LAYOUT<2>  idx;                  // (i,j) -> storage offset
+
+	public:
+		typedef LAYOUT<2> Layout;
+		enum { TILE = LAYOUT<2>::TILE };
+
+		// One TILE x TILE block (clipped at the array edges)
+		struct Tile
+		{
+			int       i0, j0;      // Element (i0,j0) is the tile's first
+			int       rows, cols;  // Tile extent, <= TILE
+			T*        data;        // Storage of (i0,j0); the tile's TILE*TILE slots follow
+			Array2D*  arr;
+			inline T& operator()(int r, int c) const { return arr->element(i0+r, j0+c); }
+		};
+
+		// Constructors:
+		Array2D() {}
+		Array2D(int nRow, int nCol) { alloc(nRow, nCol); }
+		virtual ~Array2D() {}
+
+		// Assign all elements from a given value
+		Array2D& operator=(const T& value) { Storage::operator=(value); return *this; }
+
+		// (Re)alloc array size, invalidate data, and use existing memory if possible.
+		bool alloc(int nRow, int nCol);
+		// Resize, keeping existing contents at their (i,j).
+		bool resize(int nRow, int nCol);
+
+		// Access number of rows or columns, and the storage
+		inline int  rows() const  { return idx.d[0]; }
+		inline int  cols() const  { return idx.d[1]; }
+		inline const Layout& layout() const { return idx; }
+		using Storage::space;
+		using Storage::begin;
+
+		inline T&       element(int iRow, int jCol)          {return m_data[idx(iRow,jCol)];}
+		inline const T& element(int iRow, int jCol) const    {return m_data[idx(iRow,jCol)];}
+		inline T&       operator()(int iRow, int jCol)       {return m_data[idx(iRow,jCol)];}
+		inline const T& operator()(int iRow, int jCol) const {return m_data[idx(iRow,jCol)];}
+
+		// Call f(Tile&) on every tile
+		template<typename Lambda>
+		void forEachTile(Lambda f)
+		{
+			Tile t;
+			t.arr = this;
+			for (t.i0 = 0; t.i0 < rows(); t.i0 += TILE)
+				for (t.j0 = 0; t.j0 < cols(); t.j0 += TILE)
+				{
+					t.rows = rows()-t.i0 < TILE? rows()-t.i0 : TILE;
+					t.cols = cols()-t.j0 < TILE? cols()-t.j0 : TILE;
+					t.data = m_data + idx(t.i0, t.j0);
+					f(t);
+				}
+		}
+
+		// Min and max over all elements (padding excluded). NaNs are skipped.
+		void getMinMax(T& min, T& max);
+
+		// ========= Common class interfaces  =========================
+		public:
+		typedef DSA::NewClassID<21497,0,ID_DLL> IDClass;
+		typedef Array2D BaseClass;
+		// Run-time Stream I/O: dimensions and Layout::LAYOUTID, then the idx.space()
+		// elements in storage order (read back only with the same LAYOUT)
+		DSA_Export bool put(      Stream& stream, UChar ver) const;
+		DSA_Export bool get(const Stream& stream, UChar ver);
 		// ============================================================
 	};
 
@@ -8,6 +8,10 @@
 #define DSA_ARRAY2D_INL
 //	Prerequisites:
 #include <float.h>
+#include <cmath>
+#include <cstdint>
+#include <utility> // std::move
+#include <type_traits>
 //#ifndef _WINNT_
 //#include <windows.h>
 //#endif
@@ -18,82 +22,451 @@
 
 namespace DSA
 {
+	// NaN test of an element: only floating-point types have NaNs
+	template<class T> inline bool isNaN(const T& v, std::true_type) { return std::isnan(v); }
+	template<class T> inline bool isNaN(const T&, std::false_type)  { return false; }
+	template<class T> inline bool isNaN(const T& v) { return isNaN(v, std::is_floating_point<T>()); }
+
+	// Default construct an array of given length(=space).
+	template<class T>
+	Array2D<T>::Array2D(int nRow, int nCol) : m_rows(0), m_cols(0), m_ld(0), m_mem(0)
+	{
+		alloc(nRow, nCol);
+	}
+
+	// Default construct an array of given space(>len).
+	template<class T>
+	Array2D<T>::Array2D(int nRow, int nCol, int space) : m_rows(0), m_cols(0), m_ld(0), m_mem(0)
+	{
+		if( allocBlock(space) )
+			alloc(nRow, nCol);
+	}
 
 	// Copy Construct
 	template<class T>
-	Array2D<T>::Array2D(const Array2D<T>& src) : Array<T>(src)
+	Array2D<T>::Array2D(const Array2D<T>& src) : Array<T>(), m_rows(0), m_cols(0), m_ld(0), m_mem(0)
 	{
-		m_rows = src.m_rows;
-		m_cols = src.m_cols;
+		if( alloc(src.m_rows, src.m_cols) )
+			copyRows(m_data, m_ld, src.m_data, src.m_ld, m_rows, m_cols);
 	};
 
 	// Copy Assignment
 	template<class T>
 	Array2D<T>& Array2D<T>::operator=(const Array2D<T>& src)
 	{
-		Array<T>::operator =(src);
-		m_rows = src.m_rows;
-		m_cols = src.m_cols;
+		if( this != &src && alloc(src.m_rows, src.m_cols) )
+			copyRows(m_data, m_ld, src.m_data, src.m_ld, m_rows, m_cols);
 		return *this;
 	};
 
 	template<class T>
 	Array2D<T>& Array2D<T>::operator=(const T& val)
 	{
-		for (int i = 0;  i < m_len;  ++i) 
-			m_data[i] = val;
+		for (int i = 0;  i < m_rows;  ++i)
+		{
+			T* row = m_data + i*m_ld;
+			for (int j = 0;  j < m_cols;  ++j)
+				row[j] = val;
+		}
 		return *this;
 	};
-	// Default construct an array of given length(=space).
+
 	template<class T>
-	Array2D<T>::Array2D(int nRow, int nCol) : Array<T>(nRow*nCol)
+	int Array2D<T>::stride(int nCol)
 	{
-		m_rows  = nRow;
-		m_cols  = nCol;
+		// Elements that do not tile a cache line can not be line-aligned per row
+		if( nCol <= 0 || sizeof(T) > CacheLine || CacheLine % sizeof(T) != 0 )
+			return nCol;
+		// Rows under a few cache lines stay packed: padding them would waste up to
+		// half of the memory (and bandwidth) for little gain.
+		if( (size_t)nCol * sizeof(T) < 4 * CacheLine )
+			return nCol;
+
+		const int unit = CacheLine / sizeof(T); // elements per cache line
+		int ld = (nCol + unit - 1) / unit * unit;
+
+		// Rows 4KB (or 1KB, 2KB) apart all fall in the same L1 set: pad one line.
+		size_t bytes = ld * sizeof(T);
+		if( bytes % PageSize == 0 || (bytes >= 1024 && (bytes & (bytes-1)) == 0) )
+			ld += unit;
+		return ld;
 	}
 
-	// Default construct an array of given space(>len).
+	// Keep every (i,j) inside both the old and new shapes; new elements are T().
+	// 1) Columns still fit the current stride: rows stay where they are.
+	// 2) Enough space for the new stride: move rows within the block, back-to-front
+	//    when rows spread out, front-to-back when they close up.
+	// 3) Otherwise: move each row once into a new block.
 	template<class T>
-	Array2D<T>::Array2D(int nRow, int nCol, int space) : Array<T>(nRow*nCol, space)
+	bool Array2D<T>::resize(int nRow, int nCol)
 	{
-		m_rows  = nRow;
-		m_cols  = nCol;
+		if( nRow < 0 ) nRow = 0;
+		if( nCol < 0 ) nCol = 0;
+
+		int keepRows = nRow < m_rows? nRow : m_rows;
+		int keepCols = nCol < m_cols? nCol : m_cols;
+
+		// Keep the current stride unless it is more than twice the ideal one
+		int ld = stride(nCol);
+		if( nCol <= m_ld && m_ld < 2*ld )
+			ld = m_ld;
+
+		if( nRow*ld <= abs(m_space) )
+		{
+			if( ld != m_ld )
+				moveRows(m_data, ld, m_data, m_ld, keepRows, keepCols);
+		}
+		else
+		{
+			Array2D<T> tmp;
+			if( ! tmp.alloc(nRow, nCol, ld) )
+				return false;
+			moveRows(tmp.m_data, ld, m_data, m_ld, keepRows, keepCols);
+			swapBlock(tmp); // tmp now releases the old block
+		}
+		m_rows = nRow;
+		m_cols = nCol;
+		m_ld   = ld;
+		m_len  = nRow*ld;
+
+		// Default the newly exposed elements (columns first, then rows)
+		for (int i = 0; i < keepRows; ++i)
+			for (int j = keepCols; j < nCol; ++j)
+				m_data[i*ld+j] = T();
+		for (int i = keepRows; i < nRow; ++i)
+			for (int j = 0; j < nCol; ++j)
+				m_data[i*ld+j] = T();
+		return true;
 	}
 
 	template<class T>
-	bool Array2D<T>::resize(int nRow, int nCol)
+	bool Array2D<T>::alloc(int nRow, int nCol)
 	{
-		if( Array<T>::resize(nCol * nRow) )
+		return alloc(nRow, nCol, stride(nCol));
+	}
+
+	template<class T>
+	bool Array2D<T>::alloc(int nRow, int nCol, int ld)
+	{
+		if( nRow < 0 ) nRow = 0;
+		if( nCol < 0 ) nCol = 0;
+		if( ld < nCol ) ld = nCol;
+
+		if( nRow*ld <= abs(m_space) || allocBlock(nRow*ld) )
 		{
 			m_rows  = nRow;
 			m_cols  = nCol;
+			m_ld    = ld;
+			m_len   = nRow*ld;
 			return true;
 		}
-		else
+		m_rows = 0;
+		m_cols = 0;
+		m_len  = 0;
+		return false;
+	}
+
+	template<class T>
+	void Array2D<T>::getMinMax(T& min, T& max) const
+	{
+		bool found = false;
+		for (int i = 0; i < m_rows; ++i)
 		{
-			Array<T>::resize(0);
-			m_rows = 0;
-			m_cols = 0;
+			const T* row = m_data + i*m_ld;
+			for (int j = 0; j < m_cols; ++j)
+			{
+				if( isNaN(row[j]) )
+					continue;
+				if( !found )
+				{
+					min = max = row[j];
+					found = true;
+				}
+				if (max < row[j]) max = row[j];
+				if (min > row[j]) min = row[j];
+			}
 		}
-		return false;
 	}
 
 	template<class T>
-	bool Array2D<T>::alloc(int nRow, int nCol)
+	template<typename Lambda>
+	void Array2D<T>::applyRows(Lambda f)
 	{
-		if( Array<T>::alloc(nCol * nRow) )
+		parallelFor(0, m_rows, ParallelMinWork/(m_cols+1) + 1, [&](int i0, int i1)
 		{
-			m_rows  = nRow;
-			m_cols  = nCol;
+			for (int i = i0; i < i1; ++i)
+				f(i, m_data + i*m_ld, m_cols);
+		});
+	}
+
+	template<class T>
+	template<typename Lambda>
+	void Array2D<T>::applyRows(Lambda f) const
+	{
+		parallelFor(0, m_rows, ParallelMinWork/(m_cols+1) + 1, [&](int i0, int i1)
+		{
+			for (int i = i0; i < i1; ++i)
+				f(i, (const T*)(m_data + i*m_ld), m_cols);
+		});
+	}
+
+	template<class T>
+	template<class OP>
+	bool Array2D<T>::reduceRows(Array<typename OP::Result>& out, const OP& op) const
+	{
+		if( ! out.alloc(m_rows) )
+			return false;
+		applyRows([&](int i, const T* row, int n)
+		{
+			typename OP::Acc a = op.init();
+			for (int j = 0; j < n; ++j)
+				op.add(a, row[j], j);
+			out[i] = op.result(a);
+		});
+		return true;
+	}
+
+	template<class T>
+	template<class OP>
+	bool Array2D<T>::reduceCols(Array<typename OP::Result>& out, const OP& op) const
+	{
+		typedef typename OP::Acc Acc;
+		if( ! out.alloc(m_cols) )
+			return false;
+		const int np = numThreadsFor((long)m_rows*m_cols);
+		Array<Acc> acc(np*m_cols);
+		for (int j = 0; j < acc.len(); ++j)
+			acc[j] = op.init();
+
+		// Thread p folds rows [i0,i1) into acc[p*cols, (p+1)*cols)
+		parallelRun(np, [&](int p, int n)
+		{
+			int i0 = (int)((long)m_rows*p/n), i1 = (int)((long)m_rows*(p+1)/n);
+			Acc* a = acc.begin() + p*m_cols;
+			for (int i = i0; i < i1; ++i)
+				addRow(op, a, (const T*)(m_data + i*m_ld), m_cols, i);
+		});
+
+		// Merge in row order, so ties still go to the first row
+		for (int p = 1; p < np; ++p)
+			for (int j = 0; j < m_cols; ++j)
+				op.merge(acc[j], acc[p*m_cols+j]);
+		for (int j = 0; j < m_cols; ++j)
+			out[j] = op.result(acc[j]);
+		return true;
+	}
+
+	template<class T>
+	bool Array2D<T>::put(Stream& stream, UChar /*ver*/) const
+	{
+		int dims[2] = { m_rows, m_cols };
+		return putArray<IDClass>(stream, m_data, (ULongLong)m_rows*m_ld, 2, dims, m_ld);
+	}
+
+	template<class T>
+	bool Array2D<T>::get(const Stream& stream, UChar /*ver*/)
+	{
+		ArrayHeader h;
+		return getArrayHeader<IDClass,T>(stream, h, 2) && isValid(h)
+			&& alloc((int)h.dims[0], (int)h.dims[1]) && getRows(stream, h);
+	}
+
+	template<class T>
+	bool Array2D<T>::map(const Stream& stream)
+	{
+		ArrayHeader h;
+		if( ! getArrayHeader<IDClass,T>(stream, h, 2) || ! isValid(h) )
+			return false;
+		T* p = (T*)stream.view((size_t)h.count*sizeof(T));
+		if( p == 0 ) // File stream, or an empty record
+			return alloc((int)h.dims[0], (int)h.dims[1]) && getRows(stream, h);
+		release();
+		m_data  = p;
+		m_rows  = (int)h.dims[0];
+		m_cols  = (int)h.dims[1];
+		m_ld    = (int)h.ld;
+		m_len   = (int)h.count;
+		m_space = -m_len; // Not owned, as a static buffer
+		return true;
+	}
+
+	template<class T>
+	bool Array2D<T>::getRows(const Stream& stream, const ArrayHeader& h)
+	{
+		if( (int)h.ld == m_ld )
+			return stream.read(m_data, (size_t)h.count*sizeof(T));
+
+		// Written with another stride: read row by row
+		size_t start = stream.tell();
+		for (int i = 0; i < m_rows; ++i)
+			if( ! stream.seek(start + (size_t)i*h.ld*sizeof(T)) || ! stream.read(m_data + i*m_ld, m_cols*sizeof(T)) )
+				return false;
+		return stream.seek(start + (size_t)h.count*sizeof(T));
+	}
+
+	template<class T>
+	bool Array2D<T>::allocBlock(int space)
+	{
+		release();
+		if( space <= 0 )
 			return true;
+
+		// Over-allocate one cache line to align row 0
+		void* mem = malloc(sizeof(T)*space + CacheLine);
+		if( mem == 0 )
+			return false;
+		T* data = (T*)(((uintptr_t)mem + CacheLine - 1) & ~(uintptr_t)(CacheLine - 1));
+		for (int i = 0; i < space; ++i) ::new((NewPlacement*)(data+i)) T();
+
+		m_mem   = mem;
+		m_data  = data;
+		m_space = -space; // Array<T> must not delete it
+		return true;
+	}
+
+	template<class T>
+	void Array2D<T>::release()
+	{
+		if( m_mem )
+		{
+			for (int i = 0; i < abs(m_space); ++i)
+				(m_data+i)->~T();
+			free(m_mem);
+			m_mem = 0;
+		}
+		// A static buffer is simply forgotten
+		m_data  = 0;
+		m_space = 0;
+		m_len   = 0;
+		m_rows  = 0;
+		m_cols  = 0;
+		m_ld    = 0;
+	}
+
+	template<class T>
+	void Array2D<T>::moveRows(T* dst, int ldDst, T* src, int ldSrc, int nRow, int nCol)
+	{
+		if( dst == src && ldDst == ldSrc )
+			return;
+		if( dst > src || (dst == src && ldDst > ldSrc) )
+		{
+			// Destination is above the source: back-to-front never overwrites unread data
+			for (int i = nRow-1; i >= 0; --i)
+			{
+				T* d = dst + i*ldDst;
+				T* s = src + i*ldSrc;
+				for (int j = nCol-1; j >= 0; --j)
+					d[j] = std::move(s[j]);
+			}
 		}
 		else
 		{
-			Array<T>::alloc(0);
-			m_rows = 0;
-			m_cols = 0;
+			for (int i = 0; i < nRow; ++i)
+			{
+				T* d = dst + i*ldDst;
+				T* s = src + i*ldSrc;
+				for (int j = 0; j < nCol; ++j)
+					d[j] = std::move(s[j]);
+			}
 		}
+	}
+
+	template<class T>
+	void Array2D<T>::swapBlock(Array2D<T>& o)
+	{
+		T* data = m_data;   m_data  = o.m_data;  o.m_data  = data;
+		void* mem = m_mem;  m_mem   = o.m_mem;   o.m_mem   = mem;
+		int n;
+		n = m_len;   m_len   = o.m_len;   o.m_len   = n;
+		n = m_space; m_space = o.m_space; o.m_space = n;
+		n = m_rows;  m_rows  = o.m_rows;  o.m_rows  = n;
+		n = m_cols;  m_cols  = o.m_cols;  o.m_cols  = n;
+		n = m_ld;    m_ld    = o.m_ld;    o.m_ld    = n;
+	}
+
+	template<class T>
+	void Array2D<T>::copyRows(T* dst, int ldDst, const T* src, int ldSrc, int nRow, int nCol)
+	{
+		for (int i = 0; i < nRow; ++i)
+		{
+			T* d = dst + i*ldDst;
+			const T* s = src + i*ldSrc;
+			for (int j = 0; j < nCol; ++j)
+				d[j] = s[j];
+		}
+	}
+
+	//
+	//	Array2D<T,0,0,LAYOUT> blocked layouts
+	//
+	template<class T, template<int> class LAYOUT>
+	bool Array2D<T,0,0,LAYOUT>::alloc(int nRow, int nCol)
+	{
+		if( nRow < 0 ) nRow = 0;
+		if( nCol < 0 ) nCol = 0;
+		idx.set(nRow, nCol);
+		if( Storage::alloc(1, idx.space(), idx.space()) )
+			return true;
+		idx.set(0, 0);
 		return false;
 	}
+
+	template<class T, template<int> class LAYOUT>
+	bool Array2D<T,0,0,LAYOUT>::resize(int nRow, int nCol)
+	{
+		// Any change of shape moves elements between blocks: relocate once.
+		Array2D<T,0,0,LAYOUT> tmp;
+		if( ! tmp.alloc(nRow, nCol) )
+			return false;
+		int keepRows = nRow < rows()? nRow : rows();
+		int keepCols = nCol < cols()? nCol : cols();
+		for (int i = 0; i < keepRows; ++i)
+			for (int j = 0; j < keepCols; ++j)
+				tmp.element(i,j) = std::move(element(i,j));
+		Storage::swapBlock(tmp);
+		LAYOUT<2> t = idx; idx = tmp.idx; tmp.idx = t;
+		return true;
+	}
+
+	template<class T, template<int> class LAYOUT>
+	bool Array2D<T,0,0,LAYOUT>::put(Stream& stream, UChar /*ver*/) const
+	{
+		int dims[2] = { rows(), cols() };
+		return putArray<IDClass>(stream, m_data, (ULongLong)idx.space(), 2, dims, cols(), Layout::LAYOUTID);
+	}
+
+	template<class T, template<int> class LAYOUT>
+	bool Array2D<T,0,0,LAYOUT>::get(const Stream& stream, UChar /*ver*/)
+	{
+		ArrayHeader h;
+		if( ! getArrayHeader<IDClass,T>(stream, h, 2, Layout::LAYOUTID)
+			|| h.dims[0] > 0x7FFFFFFF || h.dims[1] > 0x7FFFFFFF || h.count > 0x7FFFFFFF )
+			return false;
+		return alloc((int)h.dims[0], (int)h.dims[1]) && (ULongLong)idx.space() == h.count
+			&& stream.read(m_data, (size_t)h.count*sizeof(T));
+	}
+
+	template<class T, template<int> class LAYOUT>
+	void Array2D<T,0,0,LAYOUT>::getMinMax(T& min, T& max)
+	{
+		bool found = false;
+		forEachTile([&](const Tile& t)
+		{
+			for (int r = 0; r < t.rows; ++r)
+				for (int c = 0; c < t.cols; ++c)
+				{
+					const T& v = t(r,c);
+					if( isNaN(v) )
+						continue;
+					if( !found )
+					{
+						min = max = v;
+						found = true;
+					}
+					if (max < v) max = v;
+					if (min > v) min = v;
+				}
+		});
+	}
 }// End of namespace DSA
 #endif
\ No newline at end of file
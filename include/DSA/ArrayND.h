@@ -7,84 +7,27 @@
 
 #ifndef DSA_ARRAYND_H
 #define DSA_ARRAYND_H
+#include <cstdlib>
 #include <DSA/DSA.h>
 #include <DSA/ClassID.h>
+#include <DSA/Indexer.h>
+#include <DSA/Stream.h>
+#include <DSA/ArrayNDView.h>
 //#pragma
 namespace DSA
 {
-	// N-Dimension indexer design: (N>=1)
-
-	// Compact C-style row-major indexer:
-	// (i1,i2,i3,...) gives i3+i2*d2
-	template<int ND>
-	class Indexer;
-
-	// ==========   1D   =======================
-	template<>
-	class Indexer<1>
-	{
-	public:
-		enum { ND = 1 };
-		int  d[ND];  // the n-th dimension (size) in ND
-		int  s[ND];  // dimension size (in 1D)
-
-		bool set(int d1) { d[0]=d1;	s[0]=d1; return true; }
-		inline int operator()(int const& i1) { return i1; }
-	};
-
-	// ==========   2D   =======================
-	template<>
-	class Indexer<2>
-	{
-	public:
-		enum { ND = 2 };
-		int  d[ND];  // the n-th dimension (size) in ND
-		int  s[ND];  // dimension size (in 1D)
-
-		bool set(int d1, int d2) {d[0]=d1;d[1]=d2;s[0]=d1;s[1]=d2*d1;return true;}
-		inline int operator()(int const& i1, int const& i2) { return i1*s[0]+i2; }
-	};
-
-	// ==========   3D   =======================
-	template<>
-	class Indexer<3>
-	{
-	public:
-		enum { ND = 3 };
-		int  d[ND];  // the n-th dimension (size) in ND
-		int  s[ND];  // dimension size (in 1D)
-
-		bool set(int d1, int d2, int d3) {d[0]=d1;d[1]=d2;d[2]=d3;s[0]=d1;s[1]=d2*d1;s[2]=d3*d2*d1; return true;}
-		inline int operator()(int const& i1, int const& i2, int const& i3) { return i1*s[1]+i2*s[0]+i3; }
-	};
-
-	// ==========   4D   =======================
-	template<>
-	class Indexer<4>
-	{
-	public:
-		enum { ND = 4 };
-		int  d[ND];  // the n-th dimension (size) in ND
-		int  s[ND];  // dimension size (in 1D)
-
-		bool set(int d1, int d2, int d3, int d4) {d[0]=d1;d[1]=d2;d[2]=d3;d[3]=d4;s[0]=d1;s[1]=d2*d1;s[2]=d3*d2*d1;s[3]=d4*d3*d2*d1; return true;}
-		inline int operator()(int const& i1, int const& i2, int const& i3, int const& i4) { return i1*s[2]+i2*s[1]+i3*s[0]+i4; }
-	};
-
 	template<typename T, int ND, template<int> class INDEXER=Indexer >
 	class ArrayND
 	{
 	public:
 		T*           data;
-		int          size;
+		int          size;   // Space of data; negative if data is not owned (see map())
 		INDEXER<ND>  idx;
 
 		// Constructors. MUST have number of d# matches ND !!!
 		ArrayND():data(0),size(0)                               {}
-		ArrayND(int d1):data(0),size(0)                         { resize(d1); }
-		ArrayND(int d1, int d2):data(0),size(0)                 { resize(d1,d2); }
-		ArrayND(int d1, int d2, int d3):data(0),size(0)         { resize(d1,d2,d3); }
-		ArrayND(int d1, int d2, int d3, int d4):data(0),size(0) { resize(d1,d2,d3,d4); }
+		template<typename... D>
+		explicit ArrayND(int d1, D... dims):data(0),size(0)     { resize(d1, dims...); }
 
 		virtual ~ArrayND() { clear(); }
 
@@ -102,19 +45,66 @@ namespace DSA
 
 
 		// Access data. MUST have number of indices matches ND !!!
-		inline T& operator() (int const& i)        { return data[idx(i)]; }
-		inline T& operator() (int const& i, int const& j) { return data[idx(i,j)]; }
-		inline T& operator() (int const& i, int const& j, int const& k) { return data[idx(i,j,k)]; }
-		inline T& operator() (int const& i, int const& j, int const& k, int const& l) { return data[idx(i,j,k,l)]; }
+		template<typename... I>
+		inline T&       operator() (int const& i, I const&... j)       { return data[idx(i, j...)]; }
+		template<typename... I>
+		inline const T& operator() (int const& i, I const&... j) const { return data[idx(i, j...)]; }
 
 		// Resize. MUST have number of indices matches ND !!!
 		// All original data are deleted.
-		inline bool resize(int d1)                 { return (allocSpace(d1) && idx.set(d1)); }
-		inline bool resize(int d1, int d2)         { return (allocSpace(d1*d2) && idx.set(d1,d2)); }
-		inline bool resize(int d1, int d2, int d3) { return (allocSpace(d1*d2*d3) && idx.set(d1,d2,d3)); }
-		inline bool resize(int d1, int d2, int d3, int d4) { return (allocSpace(d1*d2*d3*d4) && idx.set(d1,d2,d3,d4)); }
+		template<typename... D>
+		inline bool resize(int d1, D... dims)      { return (idx.set(d1, dims...) && allocSpace(idx.space())); }
+
+		// Strided view of the whole array, for a row-major INDEXER (Indexer, Extents)
+		inline ArrayNDView<T,ND> view()
+		{
+			static_assert(INDEXER<ND>::LAYOUTID == 0, "ArrayND::view() needs a row-major INDEXER");
+			return ArrayNDView<T,ND>(data, idx.d);
+		}
+		inline ArrayNDView<const T,ND> view() const
+		{
+			static_assert(INDEXER<ND>::LAYOUTID == 0, "ArrayND::view() needs a row-major INDEXER");
+			return ArrayNDView<const T,ND>(data, idx.d);
+		}
+
+		// Fold dimension "axis" with a reduction operator (Reduce.h) into out, which is
+		// resized to the same dimensions but 1 along axis. Needs a row-major INDEXER.
+		template<class OP>
+		bool reduce(int axis, ArrayND<typename OP::Result,ND>& out, const OP& op = OP()) const
+		{
+			static_assert(INDEXER<ND>::LAYOUTID == 0, "ArrayND::reduce() needs a row-major INDEXER");
+			if( axis < 0 || axis >= ND )
+				return false;
+			int dims[ND];
+			for (int k = 0; k < ND; ++k)
+				dims[k] = k == axis? 1 : idx.d[k];
+			return out.idx.set(dims) && out.allocSpace(out.idx.space()) && view().reduce(axis, out.view(), op);
+		}
+		bool sum (int axis, ArrayND<T,ND>& out) const { return reduce(axis, out, ReduceSum<T>()); }
+		bool min (int axis, ArrayND<T,ND>& out) const { return reduce(axis, out, ReduceMin<T>()); }
+		bool max (int axis, ArrayND<T,ND>& out) const { return reduce(axis, out, ReduceMax<T>()); }
+		bool mean(int axis, ArrayND<T,ND>& out) const { return reduce(axis, out, ReduceMean<T>()); }
+
+		// Call f(i, p, ps, n) on every run along the last dimension, in parallel (see
+		// ArrayNDView::forEachIndex()). Needs a row-major INDEXER.
+		template<typename Lambda>
+		void forEachIndex(Lambda f)
+		{
+			static_assert(INDEXER<ND>::LAYOUTID == 0, "ArrayND::forEachIndex() needs a row-major INDEXER");
+			view().forEachIndex(f);
+		}
+
+		// Call f(brick, p) on every brick of a bricked INDEXER (TileIndexer), where p is
+		// the brick's storage: p[brick(r1,...)] is element brick.i0+(r1,...).
+		template<typename Lambda>
+		void forEachBrick(Lambda f)
+		{
+			T* p = data;
+			idx.forEachBrick([&](const typename INDEXER<ND>::Brick& b) { f(b, p + b.offset); });
+		}
 
 		// Access dimensions. MUST have number of indices matches ND !!!
+		inline int dim(int k) const { return idx.d[k]; }
 		inline int d1() const { return idx.d[0]; }
 		inline int d2() const { return idx.d[1]; }
 		inline int d3() const { return idx.d[2]; }
@@ -123,7 +113,7 @@ namespace DSA
 		// Allocate Space
 		bool allocSpace(int sz)
 		{
-			if(sz <= size)
+			if(sz <= abs(size))
 				return true;
 			else
 			{
@@ -138,40 +128,47 @@ namespace DSA
 			return false;
 		}
 		// Resize KEEP original data
-		bool keepDataResize(int newlen)
+		bool keepDataResize(int newLen)
 		{
-			if( newLen > size )
+			int oldSpace = abs(size);
+			if( newLen > oldSpace )
 			{
 				// Allocate new data space
-				int newSpace = m_space*2; // double original size
-				T* new_data = (T*)new T[newSpace];
+				int newSpace = oldSpace*2; // double original size
+				if( newSpace < newLen ) newSpace = newLen;
+				T* new_data = new T[newSpace];
 
 				// Return on allocation error
 				if (new_data == 0)
-				{
-					m_space = 0; 
-					m_len = 0;
 					return false;
-				}
-
-				// Copy construct up to srcLen elements into the new array
-				int i;
-				for (i = 0;  i < m_len;  ++i) ::new((NewPlacement*)(new_data+i)) T(m_data[i]);
-				
-				//	Class-specific-default-construct any remaining elements
-				while (i < newLen) ::new((NewPlacement*)(new_data+i++)) T();
 
-				m_len = newLen;
-				m_space = newSpace;
-
-				// MUST delete current array and redefine 
-				redefine(new_data, m_len, m_space); 
-				return true;
+				// Copy up to the old size, the rest are default constructed
+				for (int i = 0;  i < oldSpace;  ++i) new_data[i] = data[i];
 
+				clear();
+				data = new_data;
+				size = newSpace;
 			}
+			return true;
 		}
 
-		void clear() { if(data) delete [] data; data = NULL; }
+		void clear() { if(size > 0) delete [] data; data = NULL; size = 0; }
+
+		// ========= Common class interfaces  =========================
+		public:
+		typedef ArrayND BaseClass;
+		typedef DSA::NewClassID<40117,0,ID_DLL> IDClass;
+		// Run-time Stream I/O: dimensions and INDEXER::LAYOUTID, then the idx.space()
+		// elements in storage order (read back only with the same layout) in one write
+		DSA_Export bool put(      Stream& stream, UChar ver) const;
+		DSA_Export bool get(const Stream& stream, UChar ver);
+		// Load in place: data refers to the payload in a Memory or Mapped stream (see Stream.h)
+		DSA_Export bool map(const Stream& stream);
+		// ============================================================
+
+	protected:
+		// Read and check a header, and set the dimensions from it
+		bool getHeader(const Stream& stream, ArrayHeader& h);
 	};
 
 
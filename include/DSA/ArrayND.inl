@@ -21,16 +21,20 @@ namespace DSA
 
 	// Copy Construct
 	template<typename T, int ND, template<int> class INDEXER >
-	ArrayND<T,ND,INDEXER>::ArrayND(const ArrayND<T,ND,INDEXER>& src) : data(0)
+	ArrayND<T,ND,INDEXER>::ArrayND(const ArrayND<T,ND,INDEXER>& src) : data(0), size(0), idx(src.idx)
 	{
-		copy(src.data, src.size, src.size);
+		copy(src.data, abs(src.size), abs(src.size));
 	};
 
 	// Copy Assignment
 	template<typename T, int ND, template<int> class INDEXER >
 	ArrayND<T,ND,INDEXER>& ArrayND<T,ND,INDEXER>::operator=(const ArrayND<T,ND,INDEXER>& src)
 	{
-		copy(src.data, src.size, src.size);
+		if( this != &src )
+		{
+			idx = src.idx;
+			copy(src.data, abs(src.size), abs(src.size));
+		}
 //		Array<T>::operator =(src);
 		return *this;
 	};
@@ -43,8 +47,8 @@ namespace DSA
 			space = srcLen;
 		if( allocSpace(space) )
 		{
-			for (int i = 0;  i < srclen;  ++i) 
-				data[i] = val;
+			for (int i = 0;  i < srcLen;  ++i) 
+				data[i] = src[i];
 			return true;
 		}
 		return false;
@@ -53,12 +57,62 @@ namespace DSA
 	template<typename T, int ND, template<int> class INDEXER >
 	ArrayND<T,ND,INDEXER>& ArrayND<T,ND,INDEXER>::operator=(const T& val)
 	{
-		int len = idx.s[ND-1]; //TBD...
+		int len = idx.space();
 		for (int i = 0;  i < len;  ++i) 
 			data[i] = val;
 		return *this;
 	};
 
 
+
+	template<typename T, int ND, template<int> class INDEXER >
+	bool ArrayND<T,ND,INDEXER>::put(Stream& stream, UChar /*ver*/) const
+	{
+		return putArray<IDClass>(stream, data, (ULongLong)idx.space(), ND, idx.d, idx.d[ND-1], INDEXER<ND>::LAYOUTID);
+	}
+
+	template<typename T, int ND, template<int> class INDEXER >
+	bool ArrayND<T,ND,INDEXER>::getHeader(const Stream& stream, ArrayHeader& h)
+	{
+		if( ! getArrayHeader<IDClass,T>(stream, h, ND, INDEXER<ND>::LAYOUTID) )
+			return false;
+		// Check the dimensions on a copy: the array is left alone if they do not match
+		int dims[ND];
+		ULongLong n = 1;
+		for (int k = 0; k < ND; ++k)
+		{
+			dims[k] = (int)h.dims[k];
+			n = n*h.dims[k] <= h.count? n*h.dims[k] : h.count+1;
+		}
+		INDEXER<ND> tmp;
+		if( n > h.count || ! tmp.set(dims) || (ULongLong)tmp.space() != h.count )
+			return false;
+		idx = tmp;
+		return true;
+	}
+
+	template<typename T, int ND, template<int> class INDEXER >
+	bool ArrayND<T,ND,INDEXER>::get(const Stream& stream, UChar /*ver*/)
+	{
+		ArrayHeader h;
+		return getHeader(stream, h) && allocSpace((int)h.count)
+			&& stream.read(data, (size_t)h.count*sizeof(T));
+	}
+
+	template<typename T, int ND, template<int> class INDEXER >
+	bool ArrayND<T,ND,INDEXER>::map(const Stream& stream)
+	{
+		ArrayHeader h;
+		if( ! getHeader(stream, h) )
+			return false;
+		T* p = (T*)stream.view((size_t)h.count*sizeof(T));
+		if( p == 0 ) // File stream, or an empty record
+			return allocSpace((int)h.count) && stream.read(data, (size_t)h.count*sizeof(T));
+		clear();
+		data = p;
+		size = -(int)h.count; // Not owned
+		return true;
+	}
+
 }// End of namespace DSA
 #endif
\ No newline at end of file
@@ -0,0 +1,198 @@
+// ================= DSA DLL Files =====================
+// File: ArrayNDView.h
+// Non-owning strided views of ArrayND (and of any strided block of T).
+// =======================================================
+// Note:
+// A view is a pointer plus ND dimensions and ND strides (in elements). Slicing,
+// selecting, permuting and broadcasting only make a new view: nothing is copied.
+// A stride of 0 repeats the element along that dimension (broadcasting).
+//
+// The element-wise kernels (fill, copy, add, axpy, mul, apply) walk the array
+// with a RunIterator, in memory order and in maximal runs; a run with unit
+// strides goes to the same SIMD loops (Simd.h) as the owning arrays. A source of
+// size 1 along a dimension is broadcast to the destination's size.
+//
+// reduce() folds one axis with a reduction operator (Reduce.h). The other axes
+// are walked as runs along the last dimension, strip-mined so the accumulators
+// of a strip stay in L1, and the strips are split across threads.
+//
+//     ArrayND<float,3> img(480, 640, 3);
+//     ArrayNDView<float,3> red = img.view().slice(2, 0, 1);   // 480 x 640 x 1
+//     red.add(bias.view());                                  // bias: 1 x 640 x 1
+//
+
+#ifndef DSA_ARRAYNDVIEW_H
+#define DSA_ARRAYNDVIEW_H
+#include <type_traits>
+#include <DSA/DSA.h>
+#include <DSA/Simd.h>
+#include <DSA/Parallel.h>
+#include <DSA/Reduce.h>
+
+namespace DSA
+{
+	template<typename T, int ND>
+	class ArrayNDView
+	{
+	public:
+		T*   data;    // Element (0,...,0)
+		int  d[ND];   // the n-th dimension (size) in ND
+		int  s[ND];   // stride of each dimension, in elements (0: broadcast)
+
+		ArrayNDView() : data(0) { for (int k = 0; k < ND; ++k) d[k] = s[k] = 0; }
+		// A view of given dimensions and strides
+		ArrayNDView(T* p, const int* dims, const int* strides) : data(p)
+		{
+			for (int k = 0; k < ND; ++k) { d[k] = dims[k]; s[k] = strides[k]; }
+		}
+		// Packed row-major block of given dimensions
+		ArrayNDView(T* p, const int* dims);
+		// A view of T converts to a view of const T
+		template<typename U>
+		ArrayNDView(const ArrayNDView<U,ND>& src) : data(src.data)
+		{
+			for (int k = 0; k < ND; ++k) { d[k] = src.d[k]; s[k] = src.s[k]; }
+		}
+
+		// Element access. MUST have number of indices matches ND !!!
+		template<typename... I>
+		inline T& operator() (int const& i, I const&... j) const
+		{
+			static_assert(sizeof...(I)+1 == ND, "ArrayNDView<T,ND> needs ND indices");
+			return data[fold<0>(i, j...)];
+		}
+
+		// Number of elements
+		int  count() const;
+		// Packed row-major (strides are those of an ArrayND of the same dimensions)
+		bool isContiguous() const;
+
+		// Elements [b,e) of dimension "dim", every "step" (>= 1). Out of range
+		// bounds are clipped.
+		ArrayNDView slice(int dim, int b, int e, int step = 1) const;
+		// Element i of dimension "dim": one dimension less
+		ArrayNDView<T,ND-1> select(int dim, int i) const;
+		// Dimension k of the result is dimension axes[k] of this view
+		ArrayNDView permute(const int* axes) const;
+		template<typename... A>
+		ArrayNDView permute(int a0, A... axes) const
+		{
+			static_assert(sizeof...(A)+1 == ND, "permute() needs ND axes");
+			const int a[ND] = { a0, axes... };
+			return permute(a);
+		}
+		// Repeat the dimensions of size 1 to given dimensions (stride 0). Returns
+		// false (and leaves the view alone) if a dimension differs and is not 1.
+		bool broadcast(const int* dims);
+
+		// Element-wise kernels; the source is broadcast to the dimensions of this
+		// view. Return false if the dimensions do not match.
+		void fill(const T& value) const;
+		template<typename U> bool copy(const ArrayNDView<U,ND>& src) const;      // this  = src
+		template<typename U> bool add(const ArrayNDView<U,ND>& src) const;       // this += src
+		template<typename U> bool axpy(T a, const ArrayNDView<U,ND>& src) const; // this += a*src
+		template<typename U> bool mul(const ArrayNDView<U,ND>& src) const;       // this *= src
+		// f(T& x, const U& y) on every pair of elements
+		template<typename U, typename Lambda>
+		bool apply(const ArrayNDView<U,ND>& src, Lambda f) const;
+
+		// Call f(p, ps, q, qs, n) on every run of a RunIterator over this view and
+		// the broadcast source: n elements at p (stride ps) and at q (stride qs).
+		template<typename U, typename Lambda>
+		bool forEachRun(const ArrayNDView<U,ND>& src, Lambda f) const;
+
+		// Strides of this view broadcast to dimensions "dims" (see broadcast())
+		bool broadcastStrides(const int* dims, int* strides) const;
+
+		// Fold dimension "axis" with a reduction operator into out, which has the
+		// dimensions of this view but 1 along axis. False if out does not match.
+		template<typename R, class OP>
+		bool reduce(int axis, const ArrayNDView<R,ND>& out, const OP& op = OP()) const;
+
+		// Call f(i, p, ps, n) on every run along the last dimension, in parallel:
+		// i (ND ints) is the index of the run's first element, p its address, ps the
+		// stride and n the length of the run.
+		template<typename Lambda>
+		void forEachIndex(Lambda f) const;
+
+		// Offset of element i (ND ints) from data
+		inline int offset(const int* i) const
+		{
+			int o = 0;
+			for (int k = 0; k < ND; ++k) o += i[k]*s[k];
+			return o;
+		}
+		// Index i of the r-th run, counting row-major over the dimensions other than
+		// skipA and skipB (whose indices are set to 0)
+		void indexOf(long r, int skipA, int skipB, int* i) const
+		{
+			for (int k = ND-1; k >= 0; --k)
+			{
+				if( k == skipA || k == skipB )
+				{
+					i[k] = 0;
+					continue;
+				}
+				i[k] = (int)(r % d[k]);
+				r /= d[k];
+			}
+		}
+
+	protected:
+		enum { CHUNK = 256 }; // Elements per strip of a reduction (accumulators in L1)
+
+		template<int K>
+		inline int fold(int const& i) const { return i*s[K]; }
+		template<int K, typename... R>
+		inline int fold(int const& i, R const&... r) const { return i*s[K] + fold<K+1>(r...); }
+	};
+
+
+	// Multi-dimensional iterator producing runs:
+	// walks a view, together with a source of the same (or broadcast) dimensions,
+	// in the memory order of the view, one run (p, ps, q, qs, n) at a time.
+	// Dimensions of size 1 are dropped, the others are ordered by decreasing
+	// stride, and adjacent ones are coalesced whenever both strides allow, so a
+	// packed array (or a packed block of a view) is a single run.
+	//
+	//     for (RunIterator<float,3> it(v); it; ++it)
+	//         for (int j = 0; j < it.n; ++j) it.p[j*it.ps] = 0;
+	//
+	template<typename T, int ND, typename U = const T>
+	class RunIterator
+	{
+	public:
+		T*   p;    // Current run of the view: p[j*ps], j in [0,n)
+		U*   q;    // Same run of the source: q[j*qs] (0 without a source)
+		int  ps, qs;
+		int  n;    // Run length
+
+		// Runs of a view
+		explicit RunIterator(const ArrayNDView<T,ND>& v);
+		// Runs of a view and of a source broadcast to it (no runs if they do not match)
+		RunIterator(const ArrayNDView<T,ND>& v, const ArrayNDView<U,ND>& src);
+
+		// A run is available
+		inline operator bool() const { return ! m_done; }
+		// Next run
+		RunIterator& operator++();
+
+		// Dimensions left after coalescing (the last one is the run)
+		inline int dims() const { return m_nd; }
+
+	protected:
+		int   m_nd;      // Coalesced dimensions, outermost first
+		int   m_d[ND];
+		int   m_sp[ND];  // Strides of the view
+		int   m_sq[ND];  // Strides of the source
+		int   m_i[ND];   // Position of the outer dimensions
+		bool  m_done;
+
+		void init(T* pv, const int* d, const int* sp, U* qv, const int* sq);
+	};
+
+} // End of namespace DSA
+
+#include <DSA/ArrayNDView.inl>
+
+#endif
@@ -0,0 +1,405 @@
+// ================= DSA DLL Files =====================
+// File: ArrayNDView.inl
+// =======================================================
+// Note:
+//
+#ifndef DSA_ARRAYNDVIEW_INL
+#define DSA_ARRAYNDVIEW_INL
+//	Prerequisites:
+
+/*==========================================================================*\
+**				Non-inline template function definitions					**
+\*==========================================================================*/
+
+namespace DSA
+{
+	template<typename T, int ND>
+	ArrayNDView<T,ND>::ArrayNDView(T* p, const int* dims) : data(p)
+	{
+		int stride = 1;
+		for (int k = ND-1; k >= 0; --k)
+		{
+			d[k] = dims[k];
+			s[k] = stride;
+			stride *= dims[k];
+		}
+	}
+
+	template<typename T, int ND>
+	int ArrayNDView<T,ND>::count() const
+	{
+		int n = 1;
+		for (int k = 0; k < ND; ++k)
+			n *= d[k];
+		return n;
+	}
+
+	template<typename T, int ND>
+	bool ArrayNDView<T,ND>::isContiguous() const
+	{
+		int stride = 1;
+		for (int k = ND-1; k >= 0; --k)
+		{
+			if( d[k] != 1 && s[k] != stride )
+				return false;
+			stride *= d[k];
+		}
+		return true;
+	}
+
+	template<typename T, int ND>
+	ArrayNDView<T,ND> ArrayNDView<T,ND>::slice(int dim, int b, int e, int step) const
+	{
+		ArrayNDView<T,ND> v(*this);
+		if( step < 1 ) step = 1;
+		if( b < 0 )      b = 0;
+		if( e > d[dim] ) e = d[dim];
+		if( e < b )      e = b;
+		v.data   = data + (b < d[dim]? b*s[dim] : 0);
+		v.d[dim] = (e - b + step-1) / step;
+		v.s[dim] = s[dim] * step;
+		return v;
+	}
+
+	template<typename T, int ND>
+	ArrayNDView<T,ND-1> ArrayNDView<T,ND>::select(int dim, int i) const
+	{
+		ArrayNDView<T,ND-1> v;
+		v.data = data + i*s[dim];
+		for (int k = 0, m = 0; k < ND; ++k)
+			if( k != dim )
+			{
+				v.d[m] = d[k];
+				v.s[m] = s[k];
+				m++;
+			}
+		return v;
+	}
+
+	template<typename T, int ND>
+	ArrayNDView<T,ND> ArrayNDView<T,ND>::permute(const int* axes) const
+	{
+		ArrayNDView<T,ND> v(*this);
+		for (int k = 0; k < ND; ++k)
+		{
+			v.d[k] = d[axes[k]];
+			v.s[k] = s[axes[k]];
+		}
+		return v;
+	}
+
+	template<typename T, int ND>
+	bool ArrayNDView<T,ND>::broadcastStrides(const int* dims, int* strides) const
+	{
+		for (int k = 0; k < ND; ++k)
+		{
+			if( d[k] == dims[k] )
+				strides[k] = s[k];
+			else if( d[k] == 1 )
+				strides[k] = 0;
+			else
+				return false;
+		}
+		return true;
+	}
+
+	template<typename T, int ND>
+	bool ArrayNDView<T,ND>::broadcast(const int* dims)
+	{
+		int stride[ND];
+		if( ! broadcastStrides(dims, stride) )
+			return false;
+		for (int k = 0; k < ND; ++k)
+		{
+			d[k] = dims[k];
+			s[k] = stride[k];
+		}
+		return true;
+	}
+
+	template<typename T, int ND>
+	template<typename U, typename Lambda>
+	bool ArrayNDView<T,ND>::forEachRun(const ArrayNDView<U,ND>& src, Lambda f) const
+	{
+		int ss[ND];
+		if( ! src.broadcastStrides(d, ss) )
+			return false;
+		for (RunIterator<T,ND,U> it(*this, src); it; ++it)
+			f(it.p, it.ps, it.q, it.qs, it.n);
+		return true;
+	}
+
+	template<typename T, int ND>
+	void ArrayNDView<T,ND>::fill(const T& value) const
+	{
+		ArrayNDView<const T,ND> one(&value, d, s);
+		for (int k = 0; k < ND; ++k) one.s[k] = 0;
+		forEachRun(one, [](T* p, int ps, const T* q, int, int n)
+		{
+			for (int j = 0; j < n; ++j)
+				p[j*ps] = *q;
+		});
+	}
+
+	template<typename T, int ND>
+	template<typename U>
+	bool ArrayNDView<T,ND>::copy(const ArrayNDView<U,ND>& src) const
+	{
+		return forEachRun(src, [](T* p, int ps, U* q, int qs, int n)
+		{
+			if( ps == 1 && qs == 1 )
+				for (int j = 0; j < n; ++j) p[j] = q[j];
+			else
+				for (int j = 0; j < n; ++j) p[j*ps] = q[j*qs];
+		});
+	}
+
+	template<typename T, int ND>
+	template<typename U>
+	bool ArrayNDView<T,ND>::add(const ArrayNDView<U,ND>& src) const
+	{
+		// The SIMD loops need a source of the same type; others are converted
+		const bool same = std::is_same<typename std::remove_const<U>::type, T>::value;
+		return forEachRun(src, [same](T* p, int ps, U* q, int qs, int n)
+		{
+			if( same && ps == 1 && qs == 1 )
+				vadd(p, (const T*)q, n);
+			else
+				for (int j = 0; j < n; ++j) p[j*ps] += q[j*qs];
+		});
+	}
+
+	template<typename T, int ND>
+	template<typename U>
+	bool ArrayNDView<T,ND>::axpy(T a, const ArrayNDView<U,ND>& src) const
+	{
+		const bool same = std::is_same<typename std::remove_const<U>::type, T>::value;
+		return forEachRun(src, [a, same](T* p, int ps, U* q, int qs, int n)
+		{
+			if( same && ps == 1 && qs == 1 )
+				DSA::axpy(p, (const T*)q, a, n);
+			else
+				for (int j = 0; j < n; ++j) p[j*ps] += a*q[j*qs];
+		});
+	}
+
+	template<typename T, int ND>
+	template<typename U>
+	bool ArrayNDView<T,ND>::mul(const ArrayNDView<U,ND>& src) const
+	{
+		return forEachRun(src, [](T* p, int ps, U* q, int qs, int n)
+		{
+			if( ps == 1 && qs == 1 )
+				for (int j = 0; j < n; ++j) p[j] *= q[j];
+			else
+				for (int j = 0; j < n; ++j) p[j*ps] *= q[j*qs];
+		});
+	}
+
+	template<typename T, int ND>
+	template<typename U, typename Lambda>
+	bool ArrayNDView<T,ND>::apply(const ArrayNDView<U,ND>& src, Lambda f) const
+	{
+		return forEachRun(src, [&f](T* p, int ps, U* q, int qs, int n)
+		{
+			for (int j = 0; j < n; ++j)
+				f(p[j*ps], q[j*qs]);
+		});
+	}
+
+	template<typename T, int ND>
+	template<typename R, class OP>
+	bool ArrayNDView<T,ND>::reduce(int axis, const ArrayNDView<R,ND>& out, const OP& op) const
+	{
+		typedef typename OP::Acc Acc;
+		if( axis < 0 || axis >= ND )
+			return false;
+		long nOut = 1;
+		for (int k = 0; k < ND; ++k)
+		{
+			if( out.d[k] != (k == axis? 1 : d[k]) )
+				return false;
+			if( k != axis ) nOut *= d[k];
+		}
+		if( nOut == 0 )
+			return true;
+		const int len = d[axis];
+
+		if( axis == ND-1 )
+		{
+			// Fold each run into one element
+			const int sa = s[axis];
+			parallelFor(0, (int)nOut, ParallelMinWork/(len+1) + 1, [&](int r0, int r1)
+			{
+				int i[ND];
+				for (int r = r0; r < r1; ++r)
+				{
+					indexOf(r, axis, axis, i);
+					const T* p = data + offset(i);
+					Acc a = op.init();
+					for (int k = 0; k < len; ++k)
+						op.add(a, p[k*sa], k);
+					out.data[out.offset(i)] = op.result(a);
+				}
+			});
+			return true;
+		}
+
+		// Strips of at most CHUNK elements of the runs along the last dimension;
+		// each strip folds the len runs along axis into its accumulators.
+		const int  n      = d[ND-1];
+		const int  nStrip = (n + CHUNK-1) / CHUNK;
+		const long nRun   = nOut / n;
+		parallelFor(0, (int)(nRun*nStrip), ParallelMinWork/((len+1)*CHUNK) + 1, [&](int w0, int w1)
+		{
+			Acc acc[CHUNK];
+			int i[ND];
+			for (int w = w0; w < w1; ++w)
+			{
+				indexOf(w / nStrip, axis, ND-1, i);
+				i[ND-1] = (w % nStrip) * CHUNK;
+				const int m = n - i[ND-1] < CHUNK? n - i[ND-1] : CHUNK;
+				const T*  p = data + offset(i);
+				for (int j = 0; j < m; ++j)
+					acc[j] = op.init();
+				for (int k = 0; k < len; ++k, p += s[axis])
+				{
+					if( s[ND-1] == 1 )
+						addRow(op, acc, p, m, k);
+					else
+						for (int j = 0; j < m; ++j) op.add(acc[j], p[j*s[ND-1]], k);
+				}
+				R* o = out.data + out.offset(i);
+				for (int j = 0; j < m; ++j)
+					o[j*out.s[ND-1]] = op.result(acc[j]);
+			}
+		});
+		return true;
+	}
+
+	template<typename T, int ND>
+	template<typename Lambda>
+	void ArrayNDView<T,ND>::forEachIndex(Lambda f) const
+	{
+		for (int k = 0; k < ND; ++k)
+			if( d[k] == 0 )
+				return;
+		const int n = d[ND-1];
+		parallelFor(0, count()/n, ParallelMinWork/n + 1, [&](int r0, int r1)
+		{
+			int i[ND];
+			for (int r = r0; r < r1; ++r)
+			{
+				indexOf(r, ND-1, ND-1, i);
+				f((const int*)i, data + offset(i), s[ND-1], n);
+			}
+		});
+	}
+
+
+	//
+	//	RunIterator<T,ND,U>
+	//
+	template<typename T, int ND, typename U>
+	RunIterator<T,ND,U>::RunIterator(const ArrayNDView<T,ND>& v)
+	{
+		int zero[ND];
+		for (int k = 0; k < ND; ++k) zero[k] = 0;
+		init(v.data, v.d, v.s, 0, zero);
+	}
+
+	template<typename T, int ND, typename U>
+	RunIterator<T,ND,U>::RunIterator(const ArrayNDView<T,ND>& v, const ArrayNDView<U,ND>& src)
+	{
+		int ss[ND];
+		if( src.broadcastStrides(v.d, ss) )
+			init(v.data, v.d, v.s, src.data, ss);
+		else
+		{
+			int zero[ND];
+			for (int k = 0; k < ND; ++k) zero[k] = 0;
+			init(0, zero, zero, 0, zero);
+		}
+	}
+
+	template<typename T, int ND, typename U>
+	void RunIterator<T,ND,U>::init(T* pv, const int* d, const int* sp, U* qv, const int* sq)
+	{
+		p = pv;  q = qv;
+		ps = qs = 0;
+		n = 1;
+		m_nd = 0;
+		m_done = false;
+		for (int k = 0; k < ND; ++k)
+		{
+			if( d[k] == 0 )
+			{
+				n = 0;
+				m_done = true;
+				return;
+			}
+			if( d[k] == 1 )
+				continue;
+
+			// Insert by decreasing |stride| of the view (stable); broadcast (0) strides
+			// go outermost, as they repeat the same elements
+			int key = sp[k] < 0? -sp[k] : sp[k];
+			int j = m_nd++;
+			for (; j > 0; --j)
+			{
+				int prev = m_sp[j-1] < 0? -m_sp[j-1] : m_sp[j-1];
+				if( prev == 0 || (key != 0 && prev >= key) )
+					break;
+				m_d[j] = m_d[j-1];  m_sp[j] = m_sp[j-1];  m_sq[j] = m_sq[j-1];
+			}
+			m_d[j] = d[k];  m_sp[j] = sp[k];  m_sq[j] = sq[k];
+		}
+		if( m_nd == 0 )
+		{
+			m_nd = 1;  m_d[0] = 1;  m_sp[0] = m_sq[0] = 0;
+		}
+
+		// Coalesce an outer dimension into the next inner one
+		int w = m_nd-1;
+		for (int k = m_nd-2; k >= 0; --k)
+		{
+			if( m_sp[k] == m_sp[w]*m_d[w] && m_sq[k] == m_sq[w]*m_d[w] )
+				m_d[w] *= m_d[k];
+			else
+			{
+				--w;
+				m_d[w] = m_d[k];  m_sp[w] = m_sp[k];  m_sq[w] = m_sq[k];
+			}
+		}
+		for (int k = w; k < m_nd; ++k)
+		{
+			m_d[k-w] = m_d[k];  m_sp[k-w] = m_sp[k];  m_sq[k-w] = m_sq[k];
+		}
+		m_nd -= w;
+
+		for (int k = 0; k < m_nd; ++k) m_i[k] = 0;
+		n  = m_d[m_nd-1];
+		ps = m_sp[m_nd-1];
+		qs = m_sq[m_nd-1];
+	}
+
+	template<typename T, int ND, typename U>
+	RunIterator<T,ND,U>& RunIterator<T,ND,U>::operator++()
+	{
+		int k = m_nd-2;
+		for (; k >= 0; --k)
+		{
+			p += m_sp[k];
+			if( q ) q += m_sq[k];
+			if( ++m_i[k] < m_d[k] )
+				return *this;
+			p -= m_sp[k]*m_d[k];
+			if( q ) q -= m_sq[k]*m_d[k];
+			m_i[k] = 0;
+		}
+		m_done = true;
+		return *this;
+	}
+
+}// End of namespace DSA
+#endif
@@ -61,7 +61,7 @@ namespace DSA
 	//
 	// Class Registry Methods supported by one global 
 	// static ClassRegistry hash table.
-	// NOTE: Currently it supports AT MOST 2048 classes without collision. 
+	// The table starts with 2048 buckets and grows with the classes.
 	//
 	class DSA_Export ClassRegistryMethods
 	{
@@ -89,10 +89,8 @@ namespace DSA
 
 	private:
 		// A static registry hash table
+		// (hashed by HashOf<ClassID> and matched by isSame(), see Hash.h)
 		static DSA_Export Hash<ClassID, ClassRegistry*> hashTable;
-		// TBD. use ClassID::rnd(key) ??? and Warning on collisions???
-		static inline int hashing(ClassID const& key) { return (key.idfull & 0x00FFFFFF) + key.tppid; }
-		static inline bool matching(ClassID const& key0, ClassID const& key1) { return key0.isSame(key1);}
 	};
 
 		// ===== RTTHeader stores helper RTT routines ======
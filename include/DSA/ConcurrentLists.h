@@ -0,0 +1,101 @@
+// ================= DSA DLL Files =====================
+// File: ConcurrentLists.h
+// Lists sharing one storage, with lock-free concurrent inserts.
+// =======================================================
+// Note:
+// ConcurrentLists<OBJ> is the multi-threaded counterpart of Lists<OBJ> for
+// build phases: any number of threads may insert() into the same or different
+// lists at once, without a lock. The storage has a fixed capacity (alloc or
+// reserve it before the threads start); insert() fails when it is full.
+//
+// Free entries are taken from a lock-free free list whose head carries a tag,
+// incremented on every change, so a head that was popped and pushed back
+// meanwhile is not mistaken for an unchanged one (ABA). Objects are pushed on
+// the front of their list with a compare-and-swap of the list head.
+//
+// Everything else (alloc, reserve, clearList, compact) must run in a quiescent
+// phase, when no thread inserts. Lists are read with first()/nextOf()/objOf()
+// once the inserting threads have been joined.
+//
+//     ConcurrentLists<int> links;
+//     links.alloc(nNodes, nItems);
+//     parallelFor(0, nNodes, 1024, [&](int b, int e) {
+//         for (int k = b; k < e; ++k) links.insert(k, item[k]);
+//     });
+//     links.compact();  // each list contiguous for the mining phase
+//
+
+#ifndef DSA_CONCURRENTLISTS_H
+#define DSA_CONCURRENTLISTS_H
+#include <DSA/DSA.h>
+#include <atomic>
+
+namespace DSA
+{
+	template<typename OBJ>
+	class ConcurrentLists
+	{
+	public:
+		struct Node
+		{
+			std::atomic<int> next;
+			OBJ              obj;
+		};
+
+		ConcurrentLists() : m_node(0), m_space(0), m_head(0), m_count(0), m_len(0), m_free(pack(0, -1)) {}
+		virtual ~ConcurrentLists() { dealloc(); }
+
+		// len lists and room for maxEntry objects in all; all lists empty (quiescent)
+		bool alloc(int maxEntry, int len = 1);
+		// Room for maxEntry objects in all, keeping the lists (quiescent)
+		bool reserve(int maxEntry);
+
+		int totalSpace() const { return m_space; }
+		int numLists()   const { return m_len; }
+		int numEntries() const;
+		int length(int i = 0) const { return i >= 0 && i < m_len? m_count[i].load(std::memory_order_relaxed) : 0; }
+
+		// Insert to the front of list #i; thread-safe and lock-free. False if the
+		// storage is full or i is out of range.
+		bool insert(OBJ const& o, int i = 0);
+
+		// Cursor access, as Lists: entry of the 1st object of list #i, entry after
+		// entry k (-1 at the end), object of entry k
+		int        first(int i = 0) const { return i >= 0 && i < m_len? m_head[i].load(std::memory_order_acquire) : -1; }
+		int        nextOf(int k) const    { return m_node[k].next.load(std::memory_order_relaxed); }
+		OBJ&       objOf(int k)           { return m_node[k].obj; }
+		const OBJ& objOf(int k) const     { return m_node[k].obj; }
+
+		// Remove all objects of list #i (quiescent)
+		void clearList(int i = 0);
+		// Lay each list out contiguously and in order, list #0 first, followed by
+		// the free entries (quiescent). Invalidates entry indices.
+		bool compact();
+
+	protected:
+		Node*                    m_node;   // Shared storage
+		int                      m_space;  // Entries in m_node
+		std::atomic<int>*        m_head;   // First entry of each list (-1: empty)
+		std::atomic<int>*        m_count;  // Objects on each list
+		int                      m_len;    // Number of lists
+		std::atomic<ULongLong>   m_free;   // Free list head: tag (high 32 bits) and entry + 1
+
+		static inline ULongLong pack(ULongLong tag, int k) { return (tag << 32) | (ULong)(k+1); }
+		static inline int       entryOf(ULongLong h)       { return (int)(ULong)(h & 0xFFFFFFFFu) - 1; }
+
+		int  take();          // Pop a free entry (lock-free); -1 if none
+		void dealloc();
+		// Move the storage to a new block of n entries, keeping the first nKeep
+		bool relocate(int n, int nKeep);
+
+	private:
+		// A ConcurrentLists owns its storage: no copies
+		ConcurrentLists(const ConcurrentLists&);
+		ConcurrentLists& operator=(const ConcurrentLists&);
+	};
+
+} // End of namespace DSA
+
+#include <DSA/ConcurrentLists.inl>
+
+#endif
@@ -0,0 +1,186 @@
+// ================= DSA DLL Files =====================
+// File: ConcurrentLists.inl
+// =======================================================
+// Note:
+//
+#ifndef DSA_CONCURRENTLISTS_INL
+#define DSA_CONCURRENTLISTS_INL
+//	Prerequisites:
+#include <new> // std::nothrow
+
+/*==========================================================================*\
+**				Non-inline template function definitions					**
+\*==========================================================================*/
+
+namespace DSA
+{
+	template<typename OBJ>
+	bool ConcurrentLists<OBJ>::alloc(int maxEntry, int len)
+	{
+		dealloc();
+		if( maxEntry < 0 || len < 0 )
+			return false;
+		m_node  = maxEntry > 0? new (std::nothrow) Node[maxEntry] : 0;
+		m_head  = len > 0? new (std::nothrow) std::atomic<int>[len] : 0;
+		m_count = len > 0? new (std::nothrow) std::atomic<int>[len] : 0;
+		if( (maxEntry > 0 && m_node == 0) || (len > 0 && (m_head == 0 || m_count == 0)) )
+		{
+			dealloc();
+			return false;
+		}
+		m_space = maxEntry;
+		m_len   = len;
+		for (int i = 0; i < len; ++i)
+		{
+			m_head[i].store(-1, std::memory_order_relaxed);
+			m_count[i].store(0, std::memory_order_relaxed);
+		}
+		for (int k = 0; k < maxEntry; ++k)
+			m_node[k].next.store(k+1 < maxEntry? k+1 : -1, std::memory_order_relaxed);
+		m_free.store(pack(0, maxEntry > 0? 0 : -1));
+		return true;
+	}
+
+	template<typename OBJ>
+	bool ConcurrentLists<OBJ>::reserve(int maxEntry)
+	{
+		int nOld = m_space;
+		if( maxEntry <= nOld )
+			return true;
+		if( ! relocate(maxEntry, nOld) )
+			return false;
+
+		// The new entries go in front of the free list
+		ULongLong h = m_free.load();
+		for (int k = nOld; k < maxEntry-1; ++k)
+			m_node[k].next.store(k+1, std::memory_order_relaxed);
+		m_node[maxEntry-1].next.store(entryOf(h), std::memory_order_relaxed);
+		m_free.store(pack((h >> 32) + 1, nOld));
+		return true;
+	}
+
+	template<typename OBJ>
+	int ConcurrentLists<OBJ>::numEntries() const
+	{
+		int n = 0;
+		for (int i = 0; i < m_len; ++i)
+			n += m_count[i].load(std::memory_order_relaxed);
+		return n;
+	}
+
+	template<typename OBJ>
+	int ConcurrentLists<OBJ>::take()
+	{
+		ULongLong h = m_free.load(std::memory_order_acquire);
+		for (;;)
+		{
+			int k = entryOf(h);
+			if( k < 0 )
+				return -1;
+			// If another thread takes k first, the tag has moved on and the CAS fails
+			int next = m_node[k].next.load(std::memory_order_relaxed);
+			if( m_free.compare_exchange_weak(h, pack((h >> 32) + 1, next),
+					std::memory_order_acq_rel, std::memory_order_acquire) )
+				return k;
+		}
+	}
+
+	template<typename OBJ>
+	bool ConcurrentLists<OBJ>::insert(OBJ const& o, int i)
+	{
+		if( i < 0 || i >= m_len )
+			return false;
+		int k = take();
+		if( k < 0 )
+			return false;
+		m_node[k].obj = o;
+
+		// Publish the object with the new head (release)
+		int h = m_head[i].load(std::memory_order_relaxed);
+		do
+			m_node[k].next.store(h, std::memory_order_relaxed);
+		while( ! m_head[i].compare_exchange_weak(h, k, std::memory_order_release, std::memory_order_relaxed) );
+		m_count[i].fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	template<typename OBJ>
+	void ConcurrentLists<OBJ>::clearList(int i)
+	{
+		int k = first(i);
+		if( k < 0 )
+			return;
+		while( nextOf(k) >= 0 )
+			k = nextOf(k);
+		ULongLong h = m_free.load();
+		m_node[k].next.store(entryOf(h), std::memory_order_relaxed);
+		m_free.store(pack((h >> 32) + 1, m_head[i].load()));
+		m_head[i].store(-1);
+		m_count[i].store(0);
+	}
+
+	template<typename OBJ>
+	bool ConcurrentLists<OBJ>::compact()
+	{
+		if( m_space == 0 )
+			return true;
+		Node* packed = new (std::nothrow) Node[m_space];
+		if( packed == 0 )
+			return false;
+
+		// Copy the lists one after the other, each in order
+		int k = 0;
+		for (int i = 0; i < m_len; ++i)
+		{
+			int j = m_head[i].load(std::memory_order_relaxed);
+			if( j < 0 )
+				continue;
+			m_head[i].store(k, std::memory_order_relaxed);
+			for (; j >= 0; j = nextOf(j), ++k)
+			{
+				packed[k].obj = m_node[j].obj;
+				packed[k].next.store(k+1, std::memory_order_relaxed);
+			}
+			packed[k-1].next.store(-1, std::memory_order_relaxed);
+		}
+		// Then the free entries
+		for (int j = k; j < m_space; ++j)
+			packed[j].next.store(j+1 < m_space? j+1 : -1, std::memory_order_relaxed);
+		m_free.store(pack((m_free.load() >> 32) + 1, k < m_space? k : -1));
+
+		delete [] m_node;
+		m_node = packed;
+		return true;
+	}
+
+	template<typename OBJ>
+	bool ConcurrentLists<OBJ>::relocate(int n, int nKeep)
+	{
+		Node* node = new (std::nothrow) Node[n];
+		if( node == 0 )
+			return false;
+		for (int k = 0; k < nKeep; ++k)
+		{
+			node[k].next.store(m_node[k].next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			node[k].obj = m_node[k].obj;
+		}
+		delete [] m_node;
+		m_node  = node;
+		m_space = n;
+		return true;
+	}
+
+	template<typename OBJ>
+	void ConcurrentLists<OBJ>::dealloc()
+	{
+		delete [] m_node;
+		delete [] m_head;
+		delete [] m_count;
+		m_node  = 0;
+		m_head  = m_count = 0;
+		m_space = m_len = 0;
+		m_free.store(pack(0, -1));
+	}
+
+}// End of namespace DSA
+#endif
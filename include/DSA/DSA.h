@@ -113,6 +113,13 @@ namespace DSA
 	typedef int32_t  SLong;     // 4-byte (32-bit) signed int long  [0; 4,294,967,295]
 	typedef int64_t  SLongLong; // 8-byte (64-bit) signed int
 
+	// Memory hierarchy constants used for data layout (padding, alignment)
+	enum
+	{
+		CacheLine = 64,   // Bytes per cache line
+		PageSize  = 4096  // Bytes per (small) page; strides of its multiples alias in L1
+	};
+
 	// Floating data types
 	typedef float    Float;   // 4-byte (32-bit) 3.4E +/- 38 (7 digits)
 	typedef double   Double;  // 8-byte (64-bit) 1.7E +/- 308 (15 digits)
@@ -8,11 +8,124 @@
 #ifndef DSA_HASH_H
 #define DSA_HASH_H
 
+#include <cstring>
+#include <string>
+#include <DSA/ClassID.h>
 #include <DSA/Array.h>
 #include <DSA/List.h>
 
 namespace DSA
 {
+	// ======  Hash policies  =======
+	// A HASHER maps a label to 64 bits:     ULongLong operator()(L const&) const
+	// An EQUAL tells if two labels match:   bool operator()(L const&, L const&) const
+	// Hash calls them in its probe loops, where they inline. HashOf<L> has strong
+	// hashes for integers, pointers, ClassID and strings (const char*, char* and
+	// std::string), with BUILTIN = 1; other labels need a HASHER, or hash and
+	// matching functions through the adapters HashFunction/MatchFunction.
+	// The defaults, DefaultHash/DefaultEqual, are HashOf/EqualTo when BUILTIN is
+	// set, and the adapters otherwise.
+
+	// Final mix of a 64-bit value: every input bit affects every output bit
+	inline ULongLong hashMix(ULongLong x)
+	{
+		x ^= x >> 33;
+		x *= 0xFF51AFD7ED558CCDull;
+		x ^= x >> 33;
+		x *= 0xC4CEB9FE1A85EC53ull;
+		x ^= x >> 33;
+		return x;
+	}
+	// Bytes [p, p+n) (FNV-1a, then mixed)
+	inline ULongLong hashBytes(const char* p, size_t n)
+	{
+		ULongLong h = 0xCBF29CE484222325ull;
+		for (size_t i = 0; i < n; ++i)
+			h = (h ^ (UChar)p[i]) * 0x100000001B3ull;
+		return hashMix(h);
+	}
+
+	template<class L> struct HashOf { enum { BUILTIN = 0 }; }; // No built-in hash for L
+	template<class L> struct HashInt
+	{
+		enum { BUILTIN = 1 };
+		ULongLong operator()(L const& k) const { return hashMix((ULongLong)k); }
+	};
+	template<> struct HashOf<char>               : HashInt<char>               {};
+	template<> struct HashOf<signed char>        : HashInt<signed char>        {};
+	template<> struct HashOf<unsigned char>      : HashInt<unsigned char>      {};
+	template<> struct HashOf<short>              : HashInt<short>              {};
+	template<> struct HashOf<unsigned short>     : HashInt<unsigned short>     {};
+	template<> struct HashOf<int>                : HashInt<int>                {};
+	template<> struct HashOf<unsigned int>       : HashInt<unsigned int>       {};
+	template<> struct HashOf<long>               : HashInt<long>               {};
+	template<> struct HashOf<unsigned long>      : HashInt<unsigned long>      {};
+	template<> struct HashOf<long long>          : HashInt<long long>          {};
+	template<> struct HashOf<unsigned long long> : HashInt<unsigned long long> {};
+	template<class T> struct HashOf<T*>
+	{
+		enum { BUILTIN = 1 };
+		ULongLong operator()(T* const& p) const { return hashMix((ULongLong)(uintptr_t)p); }
+	};
+	template<> struct HashOf<const char*>
+	{
+		enum { BUILTIN = 1 };
+		ULongLong operator()(const char* const& s) const { return hashBytes(s, strlen(s)); }
+	};
+	template<> struct HashOf<char*> : HashOf<const char*> {};
+	template<> struct HashOf<std::string>
+	{
+		enum { BUILTIN = 1 };
+		ULongLong operator()(std::string const& s) const { return hashBytes(s.data(), s.size()); }
+	};
+	// ClassIDs that are isSame(): the 24 bits of ID without version, and the tppid
+	template<> struct HashOf<ClassID>
+	{
+		enum { BUILTIN = 1 };
+		ULongLong operator()(ClassID const& id) const
+		{ return hashMix((ULongLong)(id.idfull & 0x00FFFFFF) << 32 | id.tppid); }
+	};
+
+	template<class L> struct EqualTo { bool operator()(L const& a, L const& b) const { return a == b; } };
+	template<> struct EqualTo<const char*>
+	{
+		bool operator()(const char* const& a, const char* const& b) const { return strcmp(a, b) == 0; }
+	};
+	template<> struct EqualTo<char*> : EqualTo<const char*> {};
+	template<> struct EqualTo<ClassID>
+	{
+		bool operator()(ClassID const& a, ClassID const& b) const { return a.isSame(b); }
+	};
+
+	// Adapters for hash and matching functions (called through the pointer)
+	template<class L> struct HashFunction
+	{
+		typedef int (*Function)(L const&);
+		Function f;
+		HashFunction(Function fn = 0) : f(fn) {}
+		ULongLong operator()(L const& k) const { return hashMix((ULong)f(k)); }
+	};
+	template<class L> struct MatchFunction
+	{
+		typedef bool (*Function)(L const&, L const&);
+		Function f;
+		MatchFunction(Function fn = 0) : f(fn) {}
+		bool operator()(L const& a, L const& b) const { return f(a, b); }
+	};
+
+	// Default policies: the built-in hash and EqualTo if L has a built-in hash, else
+	// the adapters (a label without one is hashed and matched through functions).
+	template<class L, bool B = HashOf<L>::BUILTIN> struct DefaultHash : HashFunction<L>
+	{
+		DefaultHash(typename HashFunction<L>::Function fn = 0) : HashFunction<L>(fn) {}
+	};
+	template<class L> struct DefaultHash<L,true> : HashOf<L> {};
+	template<class L, bool B = HashOf<L>::BUILTIN> struct DefaultEqual : MatchFunction<L>
+	{
+		DefaultEqual(typename MatchFunction<L>::Function fn = 0) : MatchFunction<L>(fn) {}
+	};
+	template<class L> struct DefaultEqual<L,true> : EqualTo<L> {};
+
 	// HashTable Entry Type	(Analog to a drawer in a cabinet).
 	template<class L, class C>
 	struct HashEntry
@@ -28,39 +141,64 @@ namespace DSA
 
 	// Open Hash Class Template
 	// L: Label, C: Content
-	template<class L, class C>
+	// LAYOUT: storage layout of the chains (see Lists): ListsSoA keeps the links
+	// apart from the entries, so a chain walk loads an entry only to match it.
+	// HASHER, EQUAL: hash and matching policies (see above). The defaults use the
+	// built-in hash, or take hash and matching functions for other labels:
+	//     Hash<int, C> b;                                   // HashOf<int>, ==
+	//     Hash<Key, C> k(&hashing, &matching, 64, 64);      // Key: no built-in hash
+	//     Hash<int, C, ListsAoS, HashFunction<int>, MatchFunction<int> > f(&hashing, &matching, 64, 64);
+	template<class L, class C, template<class> class LAYOUT = ListsAoS, class HASHER = DefaultHash<L>, class EQUAL = DefaultEqual<L> >
 	class Hash
 	{
 	public:
-		// Hash function output should be (unsigned int).  
-		// The returned hash value WILL be hashed AGAIN by "%SIZE" to be [0, SIZE-1],
-		// so there is NO need to make sure that return hash value to be in range.
-		typedef int (*Hashing) (L const&);
-		typedef bool(*Matching)(L const&, L const&); // Matching function for labels
+		// The low bits of the 64-bit hash pick the bucket (the bucket count is a
+		// power of two), so the hash must mix all of its input into them.
+		typedef HASHER Hashing;
+		typedef EQUAL  Matching; // Matching function for labels
 		typedef HashEntry<L,C> Entry;
 
 	public:
 		// Constructors:
-		Hash(){};
 		// Given hash function and a key matching function.
-		// Number of entries should be smaller than hashSize. the Keys and hashing function
-		// are designed in such a way that clision doesn't happen, hashSize can be close to 
-		// number of entries... otherwise make hashSize twice as large of nEntryMax.
-		Hash(Hashing f, Matching m): hash(f), match(m), SIZE(0) { table.alloc(0,SIZE);};
-		Hash(Hashing f, Matching m, int nEntryMax, unsigned int hashSize)//: hash(f), match(m), SIZE(hashSize)
-		{hash = f; match = m; SIZE = hashSize; table.alloc(nEntryMax,SIZE); };
+		// hashSize (rounded up to a power of two) about the number of entries is
+		// enough: the buckets double when the entries pass maxLoadFactor() per bucket.
+		Hash(Hashing f = Hashing(), Matching m = Matching()): SIZE(0), hash(f), match(m) { init(); allocate(0, MinSize); };
+		Hash(Hashing f, Matching m, int nEntryMax, unsigned int hashSize): SIZE(0), hash(f), match(m)
+		{ init(); allocate(nEntryMax, hashSize); };
 
 		// Given hash function and table directly
 //		Hash(function f, const Array<Entry>& tab) : table(tab) { hash = f; }
 
-		// Allocate the table
-		// NOTE: hasSize MUST equal to the "SIZE" in Hash function ! ! !
-		bool allocate(int nMaxEntry, unsigned int hashSize) { SIZE = hashSize; return table.alloc(nMaxEntry, hashSize); }
+		// Allocate (and empty) the table, with hashSize buckets rounded up to a
+		// power of two (at least MinSize)
+		bool allocate(int nMaxEntry, unsigned int hashSize)
+		{
+			for(SIZE = MinSize; SIZE < hashSize && SIZE < (1u << 30); SIZE *= 2) ;
+			split = 0;
+			return table.alloc(nMaxEntry, SIZE);
+		}
+
+		// Load factor (entries per bucket) past which an add doubles the buckets.
+		// 0: the buckets are never resized. Default: 1.
+		void  setMaxLoadFactor(float f) { maxLoad = f > 0? f : 0; }
+		float maxLoadFactor() const     { return maxLoad; }
+		// Incremental rehash (default): a doubling moves the entries of a few buckets
+		// on each add instead of all at once, so no add pays for a whole rehash.
+		void  setIncrementalRehash(bool on) { incremental = on; }
+		bool  isRehashing()  { return (unsigned)table.numLists() > SIZE; }
+		// Room for n entries without resizing the buckets or the storage
+		bool reserve(int n);
+		// Halve the buckets while the entries stay under the maximum load factor,
+		// then lay the chains out contiguously (see Lists::compact())
+		bool shrinkToFit();
 
 		// Access hash table size
 		int getNumMaxEntry() { return table.totalSpace(); }
-		int getHashSize()    { return table.numLists();   }	// Should be the same as "SIZE"
-		unsigned int hashSize() { return SIZE; }            // Same value as getHashSize()
+		int getNumEntries()  { return table.numEntries(); } // Entries in the table
+		int getChainLength(unsigned int i) { return table.length(i); } // Entries in bucket i
+		int getHashSize()    { return table.numLists();   }	// Twice "SIZE" while rehashing
+		unsigned int hashSize() { return SIZE + split; }    // Buckets in use
 
 		// Destructor
 		virtual ~Hash() {};
@@ -99,12 +237,30 @@ namespace DSA
 
 	protected:
 		// Hash Table as a ListS of entries
-		Lists<Entry>  table; // Hash table
+		Lists<Entry,LAYOUT>  table; // Hash table
+
+		enum { MinSize = 16, RehashStep = 2 }; // Buckets split per add while rehashing
+
+		// Bucket of a key: buckets [0, split) of the SIZE ones are already split
+		// in two (b and b+SIZE) by the doubling under way.
+		inline unsigned int bucketOf(L const& key) const
+		{
+			unsigned int h = (unsigned int)hash(key), i = h & (SIZE-1);
+			return i < split? h & (2*SIZE-1) : i;
+		}
+		// Before an add: start or carry on doubling the buckets
+		void grow();
+		// Split n more buckets of the doubling under way
+		void rehashStep(unsigned int n);
+		void init() { split = 0; maxLoad = 1.0f; incremental = true; }
 
 	private:
 		unsigned int SIZE;   // hash size
-		Hashing	     hash;   // hash function  
-		Matching     match;	 // match function
+		unsigned int split;  // Buckets split by the doubling under way
+		float        maxLoad;
+		bool         incremental;
+		HASHER       hash;   // hash function
+		EQUAL        match;	 // match function
 	};
 
 } // End of namespace DSA
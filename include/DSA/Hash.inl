@@ -10,133 +10,186 @@
 
 namespace DSA
 {
-	template<class L, class C>
-	typename Hash<L,C>::Entry* Hash<L,C>::add(L const& lbl)
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	typename Hash<L,C,LAYOUT,HASHER,EQUAL>::Entry* Hash<L,C,LAYOUT,HASHER,EQUAL>::add(L const& lbl)
 	{
-		typename Lists<Hash<L,C>::Entry>::LinkNext* nxt = nullptr;
-		int i = hash(lbl) % SIZE; // Additional hash by "%SIZE"
-		nxt = table.getList(i);
-		while (nxt)
+		int i = bucketOf(lbl);
+		for (int k = table.first(i); k >= 0; k = table.nextOf(k))
 		{
-			if(match(nxt->obj.label, lbl))
+			if(match(table.objOf(k).label, lbl))
 			{
-				return &(nxt->obj);
+				return &(table.objOf(k));
 			}
-			nxt = table.getNext(*nxt);
 		};
 		// Now cannot find any match
-		Entry* ent = table.insert(i);
+		grow();
+		Entry* ent = table.insert(bucketOf(lbl));
 		if(ent) ent->label = lbl;
 		return ent;
 	}
 
-	template<class L, class C>
-	bool Hash<L,C>::add(L const& key, C const& content)
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	bool Hash<L,C,LAYOUT,HASHER,EQUAL>::add(L const& key, C const& content)
 	{
-		return table.insert(Entry(key,content), hash(key)%SIZE );  // Additional hash by "%SIZE"
+		Entry* ent = add(key);
+		if(ent) ent->content = content;
+		return ent != 0;
 	}
-	template<class L, class C>
-	bool Hash<L,C>::add(Entry const& ent)
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	bool Hash<L,C,LAYOUT,HASHER,EQUAL>::add(Entry const& ent)
 	{
-		return table.insert(ent, hash(ent.label)%SIZE );  // Additional hash by "%SIZE"
+		grow();
+		return table.insert(ent, bucketOf(ent.label) );
 	}
 
 	// Delete one entry (by its label) from the Hash Table
 	// Using "match()" to find matching entry
-	template<class L, class C>
-	bool Hash<L,C>::del(L  const& lbl)//  { table.remove(ent, hash(ent.label)); }
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	bool Hash<L,C,LAYOUT,HASHER,EQUAL>::del(L  const& lbl)//  { table.remove(ent, hash(ent.label)); }
 	{
-		int i = hash(lbl) % SIZE;  // Additional hash by "%SIZE"
-		typename Lists<Entry>::LinkNext* o = table.getList(i);
-		if(o)
+		int i = bucketOf(lbl);
+		int k = table.first(i);
+		if(k >= 0)
 		{
-			if(match(o->obj.label, lbl) )	// match on the 1st
+			if(match(table.objOf(k).label, lbl) )	// match on the 1st
 			{
 				table.popList(i);
 				return true;
 			}
 			else
 			{
-				while(o)// match on next
+				while(k >= 0)// match on next
 				{
-					typename Lists<Entry>::LinkNext* o2 = table.getNext(*o);
-					if(o2 && match(o2->obj.label, lbl) )
+					int k2 = table.nextOf(k);
+					if(k2 >= 0 && match(table.objOf(k2).label, lbl) )
 					{
-						table.popNext(*o);//remove the matched LinkNext
+						table.popNext(k, i);//remove the matched entry
 						return true;
 					}
-					o = o2;
+					k = k2;
 				}
 			}
 		}
 		return false;
 	}
 
-	template<class L, class C>
-	typename Hash<L,C>::Entry* Hash<L,C>::find(L  const& key)
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	typename Hash<L,C,LAYOUT,HASHER,EQUAL>::Entry* Hash<L,C,LAYOUT,HASHER,EQUAL>::find(L  const& key)
 	{
-		typename Lists<Entry>::LinkNext* o;
-		int i = hash(key) % SIZE;  // Additional hash by "%SIZE"
-		o = table.getList(i);
-		while (o)
+		int i = bucketOf(key);
+		for (int k = table.first(i); k >= 0; k = table.nextOf(k))
 		{
-			if(match(o->obj.label, key))
+			if(match(table.objOf(k).label, key))
 			{
-				return &(o->obj);
+				return &(table.objOf(k));
 			}
-			o = table.getNext(*o);
 		};
 		return NULL;
 	}
 
-	template<class L, class C>
-	C* Hash<L,C>::findContent(L  const& key)
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	C* Hash<L,C,LAYOUT,HASHER,EQUAL>::findContent(L  const& key)
 	{
-		typename Lists<Entry>::LinkNext* o;
-		int i = hash(key) % SIZE;  // Additional hash by "%SIZE"
-		o = table.getList(i);
-		while (o)
+		int i = bucketOf(key);
+		for (int k = table.first(i); k >= 0; k = table.nextOf(k))
 		{
-			if(match(o->obj.label, key))
+			if(match(table.objOf(k).label, key))
 			{
-				return &(o->obj.content);
+				return &(table.objOf(k).content);
 			}
-			o = table.getNext(*o);
 		};
 		return NULL;
 	}
 
-	template<class L, class C>
-	bool Hash<L,C>::findAll(L  const& key, Array<Entry>& res)
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	bool Hash<L,C,LAYOUT,HASHER,EQUAL>::findAll(L  const& key, Array<Entry>& res)
 	{
-		typename Lists<Entry>::LinkNext* o;
 		res.resize(0);
-		int i = hash(key) % SIZE;  // Additional hash by "%SIZE"
-		o = table.getList(i);
-		while (o)
+		int i = bucketOf(key);
+		for (int k = table.first(i); k >= 0; k = table.nextOf(k))
 		{
-			if(match(o->obj.label, key))
+			if(match(table.objOf(k).label, key))
 			{
-				res.grow();
-				res.last() = o->obj;
-//					return &(o->obj);
+				res.append(table.objOf(k));
 			}
-			o = table.getNext(*o);
 		};
 		return res.len()>0;
 	}
 
-	template<class L, class C>
-	int Hash<L,C>::collision(const L &key)
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	int Hash<L,C,LAYOUT,HASHER,EQUAL>::collision(const L &key)
 	{
-		int i = hash(key) % SIZE; // Additional hash by "%SIZE"
-		if( table.getList(i) )    // Collision
+		int i = bucketOf(key);
+		if( table.first(i) >= 0 ) // Collision
 			return i;
 		else
 			return -1;            // No collision
 	}
 
 
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	void Hash<L,C,LAYOUT,HASHER,EQUAL>::grow()
+	{
+		if( !isRehashing() && maxLoad > 0 && table.numEntries() + 1 > maxLoad*SIZE && SIZE < (1u << 30) )
+		{
+			if( ! table.resizeLists(2*SIZE) )
+				return;
+			split = 0;
+		}
+		if( isRehashing() )
+			rehashStep(incremental? (unsigned)RehashStep : SIZE);
+	}
+
+	// Linear hashing: bucket b (of SIZE) keeps the entries whose low hash bits
+	// give b modulo 2*SIZE and hands the others to bucket b+SIZE.
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	void Hash<L,C,LAYOUT,HASHER,EQUAL>::rehashStep(unsigned int n)
+	{
+		unsigned int size = SIZE;
+		for( ; n > 0 && split < size; --n, ++split)
+		{
+			unsigned int b = split;
+			table.splitList(b, b+size, [&](Entry const& e) { return ((unsigned int)hash(e.label) & (2*size-1)) != b; });
+		}
+		if( split == size )
+		{
+			SIZE  = 2*size;
+			split = 0;
+		}
+	}
+
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	bool Hash<L,C,LAYOUT,HASHER,EQUAL>::reserve(int n)
+	{
+		if( isRehashing() )
+			rehashStep(SIZE);
+		while( maxLoad > 0 && n > maxLoad*SIZE && SIZE < (1u << 30) )
+		{
+			if( ! table.resizeLists(2*SIZE) )
+				return false;
+			split = 0;
+			rehashStep(SIZE);
+		}
+		return table.reserve(n);
+	}
+
+	template<class L, class C, template<class> class LAYOUT, class HASHER, class EQUAL>
+	bool Hash<L,C,LAYOUT,HASHER,EQUAL>::shrinkToFit()
+	{
+		if( isRehashing() )
+			rehashStep(SIZE);
+		// Bucket b+half goes back to bucket b: their hashes agree modulo SIZE/2
+		while( maxLoad > 0 && SIZE/2 >= (unsigned)MinSize && table.numEntries() <= maxLoad*(SIZE/2) )
+		{
+			unsigned int half = SIZE/2;
+			for(unsigned int b = 0; b < half; b++)
+				table.splice(b, b+half);
+			if( ! table.resizeLists(half) )
+				return false;
+			SIZE = half;
+		}
+		return table.compact();
+	}
 
 } // End of namespace DSA
 #endif
\ No newline at end of file
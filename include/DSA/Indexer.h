@@ -0,0 +1,324 @@
+// ================= DSA DLL Files =====================
+// File: Indexer.h
+// XG	02/22/2009	Create (in ArrayND.h)
+// =======================================================
+// Note:
+// Indexers map N-dimension indices to a 1D storage offset. They are the
+// layout policies of ArrayND<T,ND,INDEXER> and Array2D<T,0,0,LAYOUT>.
+// Every indexer provides:
+//     int  d[ND];                  // the n-th dimension (size) in ND
+//     bool set(int d1, ...);       // set the dimensions
+//     bool set(const int* dims);   // same, from an array of ND dimensions
+//     int  space() const;          // storage (number of T) for the dimensions
+//     int  operator()(int i1,...); // storage offset of an element
+//     enum { LAYOUTID };           // storage order (0: row-major), recorded in stream headers
+//
+
+#ifndef DSA_INDEXER_H
+#define DSA_INDEXER_H
+#include <DSA/DSA.h>
+#if defined(__BMI2__)
+#include <immintrin.h> // _pdep_u32, _pext_u32
+#endif
+
+namespace DSA
+{
+	// N-Dimension indexer design: (N>=1)
+
+	// Compact C-style row-major indexer:
+	// (i1,i2,...,iN) gives i1*s[0] + i2*s[1] + ... + iN, with s[N-1] = 1 and
+	// s[k] = s[k+1]*d[k+1]. Strides are computed once by set(); operator() folds
+	// the indices at compile time (one multiply-add per dimension, no loop).
+	template<int N>
+	class Indexer
+	{
+	public:
+		enum { ND = N, LAYOUTID = 0 };
+		int  d[ND];  // the n-th dimension (size) in ND
+		int  s[ND];  // row-major stride of each dimension (in 1D)
+
+		Indexer() { for (int k = 0; k < ND; ++k) d[k] = s[k] = 0; }
+
+		template<typename... I>
+		inline bool set(int d1, I... dims)
+		{
+			static_assert(sizeof...(I)+1 == ND, "Indexer<ND>::set() needs ND dimensions");
+			const int n[ND] = { d1, dims... };
+			return set(n);
+		}
+		bool set(const int* n)
+		{
+			int stride = 1;
+			for (int k = ND-1; k >= 0; --k)
+			{
+				if( n[k] < 0 )
+					return false;
+				d[k] = n[k];
+				s[k] = stride;
+				stride *= n[k];
+			}
+			return true;
+		}
+		inline int space() const { return d[0]*s[0]; }
+
+		template<typename... I>
+		inline int operator()(int const& i1, I const&... i) const
+		{
+			static_assert(sizeof...(I)+1 == ND, "Indexer<ND> needs ND indices");
+			return fold<0>(i1, i...);
+		}
+
+	protected:
+		template<int K>
+		inline int fold(int const& i) const { return i*s[K]; }
+		template<int K, typename... R>
+		inline int fold(int const& i, R const&... r) const { return i*s[K] + fold<K+1>(r...); }
+	};
+
+
+	// Compile-time fixed extents: ArrayND<T,3,Extents<8,8,3>::Indexer> has its
+	// dimensions, strides and space as constants, so the index math of an inner
+	// loop constant-folds (e.g. i*24 + j*3 + k). set() only accepts the extents.
+	template<int... E>
+	struct Extents
+	{
+		enum { ND = sizeof...(E) };
+
+		// Product of a list of extents
+		template<int... X> struct Product;
+		template<int X0, int... X> struct Product<X0,X...> { enum { value = X0*Product<X...>::value }; };
+		template<int Dummy> struct Product<Dummy> { enum { value = Dummy }; };
+
+		// Stride of dimension K: product of the extents after it
+		template<int K, int... X> struct Stride;
+		template<int X0, int... X> struct Stride<0,X0,X...> { enum { value = Product<1,X...>::value }; };
+		template<int K, int X0, int... X> struct Stride<K,X0,X...> { enum { value = Stride<K-1,X...>::value }; };
+
+		template<int N>
+		class Indexer
+		{
+		public:
+			enum { ND = N, SPACE = Product<E...>::value, LAYOUTID = 0 };
+			static_assert(N == sizeof...(E), "Extents<E...>::Indexer<ND> needs ND extents");
+			int  d[ND];  // the n-th dimension (size) in ND (always E...)
+
+			Indexer() { const int e[ND] = { E... }; for (int k = 0; k < ND; ++k) d[k] = e[k]; }
+
+			template<typename... I>
+			inline bool set(int d1, I... dims) const
+			{
+				static_assert(sizeof...(I)+1 == ND, "Indexer<ND>::set() needs ND dimensions");
+				const int n[ND] = { d1, dims... };
+				return set(n);
+			}
+			inline bool set(const int* n) const
+			{
+				for (int k = 0; k < ND; ++k)
+					if( n[k] != d[k] )
+						return false;
+				return true;
+			}
+			static constexpr int space() { return SPACE; }
+
+			template<typename... I>
+			inline constexpr int operator()(int const& i1, I const&... i) const
+			{
+				static_assert(sizeof...(I)+1 == ND, "Indexer<ND> needs ND indices");
+				return fold<0>(i1, i...);
+			}
+
+		protected:
+			template<int K>
+			static constexpr int fold(int const& i) { return i*Stride<K,E...>::value; }
+			template<int K, typename... R>
+			static constexpr int fold(int const& i, R const&... r) { return i*Stride<K,E...>::value + fold<K+1>(r...); }
+		};
+	};
+
+	// Z-order (Morton) indexer:
+	// Bits of (i,j) are interleaved, so every aligned 2^k x 2^k block is contiguous,
+	// and vertical neighbours are (mostly) in the same cache line as horizontal ones.
+	// Each dimension is padded to a power of two; on a non-square array the Z-order
+	// squares of the smaller edge are stacked along the longer one.
+	template<int ND>
+	class MortonIndexer;
+
+	template<>
+	class MortonIndexer<2>
+	{
+	public:
+		enum { ND = 2, TILE = 8, LAYOUTID = 1 };
+		int  d[ND];  // the n-th dimension (size) in ND
+		int  p[ND];  // power-of-two padded dimensions
+		int  b;      // bits of each index interleaved (log2 of the smaller padded edge)
+		int  mask;   // (1<<b)-1
+
+		MortonIndexer() : b(0), mask(0) { d[0]=d[1]=p[0]=p[1]=0; }
+
+		bool set(int d1, int d2)
+		{
+			d[0]=d1; d[1]=d2;
+			p[0]=pow2(d1); p[1]=pow2(d2);
+			b = 0;
+			while( (1<<(b+1)) <= (p[0]<p[1]? p[0] : p[1]) ) b++;
+			mask = (1<<b)-1;
+			return true;
+		}
+		bool set(const int* n) { return set(n[0],n[1]); }
+		inline int space() const { return p[0]*p[1]; }
+
+		// Row bits go to odd positions, column bits to even ones: j is the fastest.
+		inline int operator()(int const& i1, int const& i2) const
+		{
+			return (((i1|i2)>>b)<<(2*b)) | (int)(spread(i1&mask)<<1 | spread(i2&mask));
+		}
+		// Inverse: element (i1,i2) at a storage offset
+		inline void coords(int k, int& i1, int& i2) const
+		{
+			int   hi = (k>>(2*b))<<b;
+			ULong lo = (ULong)k & ((1u<<(2*b))-1);
+			i1 = (int)compact(lo>>1) | (p[0]>p[1]? hi : 0);
+			i2 = (int)compact(lo)    | (p[0]>p[1]? 0 : hi);
+		}
+
+		// Spread the low 16 bits to the even bit positions (and back).
+		static inline ULong spread(ULong x)
+		{
+#if defined(__BMI2__)
+			return _pdep_u32(x, 0x55555555u);
+#else
+			x &= 0x0000FFFF;
+			x = (x | (x << 8)) & 0x00FF00FF;
+			x = (x | (x << 4)) & 0x0F0F0F0F;
+			x = (x | (x << 2)) & 0x33333333;
+			x = (x | (x << 1)) & 0x55555555;
+			return x;
+#endif
+		}
+		static inline ULong compact(ULong x)
+		{
+#if defined(__BMI2__)
+			return _pext_u32(x, 0x55555555u);
+#else
+			x &= 0x55555555;
+			x = (x | (x >> 1)) & 0x33333333;
+			x = (x | (x >> 2)) & 0x0F0F0F0F;
+			x = (x | (x >> 4)) & 0x00FF00FF;
+			x = (x | (x >> 8)) & 0x0000FFFF;
+			return x;
+#endif
+		}
+		static inline int pow2(int n) { int p = 1; while( p < n ) p <<= 1; return p; }
+	};
+
+
+	// Tiled (bricked) indexer:
+	// TILE^ND bricks (8 x 8 tiles in 2-D, 8 x 8 x 8 bricks in 3-D) are stored
+	// contiguously, row-major inside a brick, and the bricks themselves are
+	// row-major. Edges are padded to whole bricks. A brick of floats is 2 KB in
+	// 3-D, so a kernel working brick by brick (forEachBrick()) stays in L1
+	// whichever axis it sweeps.
+	template<int N>
+	class TileIndexer
+	{
+	public:
+		enum { ND = N, TILE = 8, SHIFT = 3, BRICK = 1<<(SHIFT*N), LAYOUTID = 2 }; // BRICK: elements per brick
+		int  d[ND];  // the n-th dimension (size) in ND
+		int  t[ND];  // number of tiles (bricks) along each dimension
+		int  b[ND];  // row-major stride of each dimension, in bricks
+
+		TileIndexer() { for (int k = 0; k < ND; ++k) d[k] = t[k] = b[k] = 0; }
+
+		template<typename... I>
+		inline bool set(int d1, I... dims)
+		{
+			static_assert(sizeof...(I)+1 == ND, "TileIndexer<ND>::set() needs ND dimensions");
+			const int n[ND] = { d1, dims... };
+			return set(n);
+		}
+		bool set(const int* n)
+		{
+			int stride = 1;
+			for (int k = ND-1; k >= 0; --k)
+			{
+				if( n[k] < 0 )
+					return false;
+				d[k] = n[k];
+				t[k] = (n[k]+TILE-1)>>SHIFT;
+				b[k] = stride;
+				stride *= t[k];
+			}
+			return true;
+		}
+		inline int space() const { return t[0]*b[0]*BRICK; }
+
+		template<typename... I>
+		inline int operator()(int const& i1, I const&... i) const
+		{
+			static_assert(sizeof...(I)+1 == ND, "TileIndexer<ND> needs ND indices");
+			return (brick<0>(i1, i...) << (SHIFT*ND)) | inner<0>(i1, i...);
+		}
+
+		// Inverse: element (i1,i2,...) at a storage offset
+		void coords(int k, int* i) const
+		{
+			int bk = k>>(SHIFT*ND);
+			for (int m = 0; m < ND; ++m)
+				i[m] = (((bk/b[m]) % t[m])<<SHIFT) | ((k>>(SHIFT*(ND-1-m))) & (TILE-1));
+		}
+		template<typename... I>
+		inline void coords(int k, int& i1, I&... i) const
+		{
+			static_assert(sizeof...(I)+1 == ND, "TileIndexer<ND>::coords() needs ND indices");
+			int c[ND];
+			coords(k, c);
+			assign<0>(c, i1, i...);
+		}
+
+		// One brick, clipped at the array edges
+		struct Brick
+		{
+			int  i0[ND];   // Its first element
+			int  n[ND];    // Its extent along each dimension, <= TILE
+			int  offset;   // Storage offset of its first element; BRICK elements follow
+
+			// Offset of element i0+(r1,r2,...) from the start of the brick
+			template<typename... I>
+			inline int operator()(int const& r1, I const&... r) const { return inner<0>(r1, r...); }
+		};
+
+		// Call f(const Brick&) on every brick, in storage order
+		template<typename Lambda>
+		void forEachBrick(Lambda f) const
+		{
+			Brick br;
+			int nb = t[0]*b[0];
+			for (br.offset = 0; br.offset < nb*BRICK; br.offset += BRICK)
+			{
+				coords(br.offset, br.i0);
+				for (int m = 0; m < ND; ++m)
+					br.n[m] = d[m]-br.i0[m] < TILE? d[m]-br.i0[m] : TILE;
+				f((const Brick&)br);
+			}
+		}
+
+	protected:
+		// Brick index, and offset inside the brick, of an element
+		template<int K>
+		inline int brick(int const& i) const { return (i>>SHIFT)*b[K]; }
+		template<int K, typename... R>
+		inline int brick(int const& i, R const&... r) const { return (i>>SHIFT)*b[K] + brick<K+1>(r...); }
+		template<int K>
+		static inline int inner(int const& i) { return (i&(TILE-1)) << (SHIFT*(ND-1-K)); }
+		template<int K, typename... R>
+		static inline int inner(int const& i, R const&... r) { return ((i&(TILE-1)) << (SHIFT*(ND-1-K))) | inner<K+1>(r...); }
+
+		template<int K>
+		static inline void assign(const int* c, int& i) { i = c[K]; }
+		template<int K, typename... R>
+		static inline void assign(const int* c, int& i, R&... r) { i = c[K]; assign<K+1>(c, r...); }
+	};
+
+} // End of namespace DSA
+
+#endif
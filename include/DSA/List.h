@@ -9,14 +9,17 @@
 #define DSA_LIST_H
 
 #include <list>
+#include <DSA/Array.h>
+#include <DSA/Parallel.h>
 namespace DSA
 {
-	// Last Edit: 08/19/2009
-	// A Table and Cursor Based Lists(Array) Implementation
-	// Every list in the lists(array) share the same data for best memory efficiency.
-	// It can also be used as one single list.
+	// Storage layouts of Lists: entry k of the shared storage has a link next(k)
+	// (index of the next entry, -1 at the end) and an object obj(k).
+
+	// Array of structures: the link and the object of an entry are side by side.
+	// Entries are LinkNext, so lists can also be walked with getList()/getNext().
 	template<typename OBJ>
-	class Lists
+	class ListsAoS
 	{
 	public:
 		typedef struct linkNext // LinkNext data type
@@ -28,109 +31,351 @@ namespace DSA
 			~linkNext() {}
 		} LinkNext;
 
-		Lists()  { avail = -1; }
+		inline int&       next(int k)       { return log[k].next; }
+		inline int        next(int k) const { return log[k].next; }
+		inline OBJ&       obj(int k)        { return log[k].obj;  }
+		inline const OBJ& obj(int k) const  { return log[k].obj;  }
+		inline int        len() const       { return log.len();   }
+		bool alloc(int n)                   { return log.alloc(n, n); }
+		void swap(ListsAoS& o)              { log.swap(o.log); }
+
+		inline LinkNext*  at(int k)                     { return &log[k]; }
+		inline int        indexOf(const LinkNext* p) const { return (int)(p - log.begin()); }
+
+	protected:
+		Array<LinkNext>  log;
+	};
+
+	// Structure of arrays: the links and the objects are in separate arrays, so
+	// walking a chain touches only the links (4 bytes per hop) until an object is
+	// needed. Lists are walked with first()/nextOf()/objOf().
+	template<typename OBJ>
+	class ListsSoA
+	{
+	public:
+		struct LinkNext; // No entry structure: getList()/getNext() are not available
+
+		inline int&       next(int k)       { return link[k]; }
+		inline int        next(int k) const { return link[k]; }
+		inline OBJ&       obj(int k)        { return objs[k]; }
+		inline const OBJ& obj(int k) const  { return objs[k]; }
+		inline int        len() const       { return link.len(); }
+		bool alloc(int n)                   { return link.alloc(n, n) && objs.alloc(n, n); }
+		void swap(ListsSoA& o)              { link.swap(o.link); objs.swap(o.objs); }
+
+	protected:
+		Array<int>  link;
+		Array<OBJ>  objs;
+	};
+
+	// Last Edit: 08/19/2009
+	// A Table and Cursor Based Lists(Array) Implementation
+	// Every list in the lists(array) share the same data for best memory efficiency.
+	// It can also be used as one single list.
+	// Each list keeps a tail cursor and a count, so appending (insertAtEnd),
+	// getLast, splicing a list onto another, length and clearList are O(1).
+	// The shared storage grows geometrically (see setGrowth) when it runs out of
+	// entries; reserve() sizes it up front for bulk builds.
+	// After many inserts and removes a list hops around the storage; compact()
+	// lays every list out contiguously again (see setAutoCompact).
+	// In the doubly-linked mode (setDoublyLinked) every entry also knows its
+	// previous entry and its list, so an object can be unlinked, moved to the
+	// front or followed by a new one in O(1) given its handle (its entry index).
+	// LAYOUT is the storage layout: ListsAoS (default) or ListsSoA.
+	template<typename OBJ, template<class> class LAYOUT = ListsAoS>
+	class Lists
+	{
+	public:
+		typedef LAYOUT<OBJ>                    Storage;
+		typedef typename Storage::LinkNext     LinkNext;
+
+		Lists()  { avail = -1; nUsed = 0; growth = 2.0f; nChanged = 0; compactAt = 0; doubly = false; }
 		virtual ~Lists() {}
 		// allocate size of lists.
 		// len is the number of list; maxEntry is the space reserved for entries for all lists.
 		bool alloc(int maxEntry, int len=1);
+		// Make room for "maxEntry" entries in all (existing entries are kept), so
+		// that many objects can be inserted without growing the storage.
+		bool reserve(int maxEntry) { return growLog(maxEntry, 1.0f); }
+		// Storage grows by this factor (> 1) when it runs out of entries. Default: 2.
+		void setGrowth(float factor) { if(factor > 1.0f) growth = factor; }
+
+		// Rewrite the storage so that the objects of each list are contiguous and in
+		// order (list #0 first) and the free entries follow. Invalidates pointers to
+		// objects and LinkNexts.
+		bool compact();
+		// Fraction of the links between objects that do not go to the next entry of
+		// the storage: 0 after compact(). O(number of objects).
+		float fragmentation() const;
+		// Compact automatically, on an insert, once fragmentation() exceeds "threshold"
+		// (checked after every threshold x numEntries() inserts and removes). 0: off.
+		void setAutoCompact(float threshold) { compactAt = threshold > 0? threshold : 0; nChanged = 0; }
 
 		// access list info:
-		int totalSpace() {return log.space(); }
+		int totalSpace() {return log.len();   }
 		int numLists()   {return list.len();  }
+		int numEntries() {return nUsed;       } // Objects on all lists
 
 		// Insert to the front of list #i: // Faster than insert to the end...
 		bool insert(OBJ const& o, int i = 0);
 		OBJ* insert(int i = 0); // Return the undefined object 
 
-		// Insert to end of list #i	//Less efficient than insert()
+		// Insert to end of list #i
 		bool insertAtEnd(OBJ const& o, int i = 0);
 		OBJ* insertAtEnd(int i = 0); // Return the undefined object
 
+		// Move all objects of list #j to the end of list #i (list #j becomes empty)
+		bool splice(int i, int j);
+		// Move the objects of list #i for which moves(obj) is true to the end of
+		// list #j, keeping their order. Only links change: pointers to the objects
+		// stay valid. Returns the number of objects moved.
+		template<typename Pred> int splitList(int i, int j, Pred moves);
+		// Change the number of lists: new lists are empty. False if a list to be
+		// dropped is not empty.
+		bool resizeLists(int len);
+
+		// Replace the contents of all lists: objs[k] goes to the end of list
+		// #listIds[k], k in [0,n). Counts the objects of each list, then places them
+		// in one pass (split across threads when n is large), so that each list comes
+		// out contiguous and in input order. False if a list id is out of range.
+		bool buildFrom(const OBJ* objs, const int* listIds, int n);
+
 		// delete/remove from list #i  // Must have ==(OBJ,OBJ) defined ! ! !
 		bool remove(OBJ const& o, int i = 0);
 		// locate query	in list #i [operator == for OBJ must be defined]. "i" MUST be [0 len)
 		// Used for check if list #i already has given obj
 		OBJ* locate(OBJ const& o, int i = 0);
 
-		// ======  Access objects on the list =======
+		// ======  Access objects on the list (any layout) =======
+		// Entry of the 1st (last) object on list #i; -1 on empty list.
+		int  first(int i=0) const     { return i>=0 && i<list.len()? list[i] : -1; }
+		int  last(int i=0) const      { return i>=0 && i<list.len()? tail[i] : -1; }
+		// Entry after entry k; -1 at the end of the list.
+		int  nextOf(int k) const      { return log.next(k); }
+		// Object of entry k
+		OBJ&       objOf(int k)       { return log.obj(k); }
+		const OBJ& objOf(int k) const { return log.obj(k); }
+
+		// ======  Access objects on the list (ListsAoS) =======
 		// Get the 1st object on list #i
-		LinkNext* getList(int i=0)    { if(i>=0 && i<list.len()) return list[i]>=0? &(log[list[i]]) : 0; else return 0; }
+		LinkNext* getList(int i=0)    { int k = first(i); return k>=0? log.at(k) : 0; }
 		// Get the next object after the given LinkNext
-		LinkNext* getNext(const LinkNext& o) { return o.next >=0? &(log[o.next])  : 0; }
+		LinkNext* getNext(const LinkNext& o) { return o.next >=0? log.at(o.next) : 0; }
 		// Get the last object on list #i. Null on empty list.
-		LinkNext* getLast(int i=0);
+		LinkNext* getLast(int i=0)    { int k = last(i); return k>=0? log.at(k) : 0; }
 
 		// Remove all list elements
 		void clearList(int i=0) 
 		{
-			LinkNext* last = getLast(i); 
-			if(last) {last->next = avail; avail = log[list[i]];	list[i]=-1;}
+			int k = last(i); 
+			if(k>=0) {log.next(k) = avail; avail = list[i]; list[i]=-1; tail[i]=-1; nUsed -= count[i]; count[i]=0;}
 		}
 		// pop-out the 1st element on list #i
-		void popList(int i=0) {if(list[i]>=0) { int j = list[i]; list[i]=log[j].next; log[j].next = avail; avail = j; } }
-		// pop-out the element next(after) to given LinkNext
-		void popNext(LinkNext& o) 
+		void popList(int i=0)
 		{
-			int k = o.next; 
+			if(i>=0 && i<list.len() && list[i]>=0)
+			{
+				int j = list[i];
+				list[i]=log.next(j);
+				if(list[i]<0) tail[i] = -1;
+				setPrev(list[i], -1);
+				log.next(j) = avail;
+				avail = j;
+				count[i]--;
+				nUsed--;
+				nChanged++;
+			}
+		}
+		// pop-out the element next(after) to given LinkNext on list #i (its list:
+		// the tail and count of list #i are updated)
+		void popNext(LinkNext& o, int i) { popNext(log.indexOf(&o), i); }
+		// pop-out the element next(after) to entry j on list #i
+		void popNext(int j, int i) 
+		{
+			int k = i>=0 && i<list.len()? log.next(j) : -1;
 			if(k>=0) 
 			{
-				o.next = log[k].next;
-				log[k].next = avail;
+				log.next(j) = log.next(k);
+				if(tail[i] == k) tail[i] = j;
+				setPrev(log.next(j), j);
+				log.next(k) = avail;
 				avail = k;
+				count[i]--;
+				nUsed--;
+				nChanged++;
 			}
 		}
 
 
 		// Count objects on list #i
-		int  length(int i=0);
+		int  length(int i=0) const { return i>=0 && i<count.len()? count[i] : 0; }
+
+		// ======  Doubly-linked mode =======
+		// Keep a previous link and the list of every entry (O(number of objects) to
+		// turn on). splice() then costs O(length of the moved list).
+		void setDoublyLinked(bool on);
+		bool isDoublyLinked() const { return doubly; }
+		// Handles are entry indices: first(i), last(i), nextOf(h) or the return of
+		// insertAfter(). They stay valid until the object is removed, or compact()
+		// or buildFrom() (also an automatic compaction, see setAutoCompact) runs.
+		// All of the following need the doubly-linked mode and a live handle.
+		int  prevOf(int h) const { return prev[h]; }  // -1 at the front
+		int  listOf(int h) const { return owner[h]; }
+		// Remove the object of handle h from its list
+		void unlink(int h);
+		// Move the object of handle h to the front of its list
+		void moveToFront(int h);
+		// Insert an object after handle h, in the same list; its handle, or -1
+		int  insertAfter(int h, OBJ const& o);
 
 
 	private:
 		Array<int>       list;	// List item(s).
-		Array<LinkNext>  log;   // Shared data entries/strage for all lists.
+		Array<int>       tail;	// Last item of each list (-1: empty list)
+		Array<int>       count;	// Objects on each list
+		int              nUsed; // Objects on all lists
+		Storage          log;   // Shared data entries/strage for all lists.
 		int              avail; // Next available space in "log"
-		int growLog(int n);     // When number of entries exceeds limits.
+		float            growth;// Storage growth factor
+		int              nChanged;  // Inserts and removes since the last compaction check
+		float            compactAt; // Auto-compaction threshold (0: off)
+		bool growLog(int n, float factor); // Room for n entries: at least factor times the current
+		void autoCompact()  // Before an insert
+		{
+			if( compactAt > 0 && nChanged > compactAt*nUsed + 64 )
+			{
+				if( fragmentation() > compactAt ) compact();
+				nChanged = 0;
+			}
+		}
+		int append(int i);      // Link a free entry at the end of list #i
+
+		bool             doubly; // Doubly-linked mode
+		Array<int>       prev;   // Previous entry of each entry (doubly-linked mode)
+		Array<int>       owner;  // List of each entry (doubly-linked mode)
+		inline void setPrev(int k, int p) { if(doubly && k>=0) prev[k] = p; }
+		void relink();           // Rebuild prev and owner from the lists
+	};
+
+
+	// Unrolled lists: each entry of the shared storage (a Lists of blocks) holds up
+	// to K objects of one list, so a traversal visits K objects per link hop. The
+	// default K fills about a cache line. Objects keep their order within a list;
+	// removing one shifts the rest of its block, and an emptied block is unlinked.
+	template<typename OBJ, int K = (sizeof(OBJ) < CacheLine/2? (int)((CacheLine-2*sizeof(int))/sizeof(OBJ)) : 1)>
+	class UnrolledLists
+	{
+	public:
+		struct Block
+		{
+			int n;       // Objects in use: obj[0,n)
+			OBJ obj[K];
+			Block() : n(0) {}
+		};
+		typedef Lists<Block> Blocks;
+
+		// len lists; room for maxEntry objects in all (at least)
+		bool alloc(int maxEntry, int len=1);
+		bool reserve(int maxEntry) { return blocks.reserve((maxEntry+K-1)/K); }
+
+		int numLists()   const { return nUsed.len(); }
+		int numEntries() const { int n = 0; for(int i = 0; i < nUsed.len(); i++) n += nUsed[i]; return n; }
+		int length(int i=0) const { return i>=0 && i<nUsed.len()? nUsed[i] : 0; }
+
+		// Insert to the front (end) of list #i
+		bool insert(OBJ const& o, int i = 0);
+		bool insertAtEnd(OBJ const& o, int i = 0);
+		// delete/remove the first match from list #i  // Must have ==(OBJ,OBJ) defined ! ! !
+		bool remove(OBJ const& o, int i = 0);
+		// locate query	in list #i
+		OBJ* locate(OBJ const& o, int i = 0);
+		// Remove all objects of list #i
+		void clearList(int i=0) { if(i>=0 && i<nUsed.len()) { blocks.clearList(i); nUsed[i] = 0; } }
+
+		// Call f(OBJ&) on every object of list #i, in order
+		template<typename Lambda> void forEach(int i, Lambda f);
+
+		// Blocks of list #i (cursor API of Lists): first(i), nextOf(k), block(k)
+		int    first(int i=0) const { return blocks.first(i); }
+		int    nextOf(int k) const  { return blocks.nextOf(k); }
+		Block& block(int k)         { return blocks.objOf(k); }
+
+		// Lay every list's blocks out contiguously (see Lists::compact())
+		bool compact() { return blocks.compact(); }
+
+	protected:
+		Blocks      blocks;
+		Array<int>  nUsed; // Objects on each list
 	};
 
 //	std::list<int> lst;	//test
 
-	// TBD:
-	// Cache version
+	// Cache version: Lists with a fixed capacity, held inline (on the stack or in
+	// the owning object), which never touches the heap.
 	// N is the number of list. OBJ is the type of list objects.
-	// M is the total number of list items reserved...
+	// M is the total number of list items reserved: inserts fail beyond it.
+	// Same interface as Lists; push and pop at either end are O(1).
 	template<int N, typename OBJ, int M>
 	class ListsCache
 	{
-		struct Linked // Linked storage
-		{
-			int next;
-			OBJ obj;
-			Linked(){};
-			~Linked();
-		};
+	public:
+		typedef typename ListsAoS<OBJ>::LinkNext LinkNext;
+
+		ListsCache() { clear(); }
+		// Empty all lists
+		void clear();
 
-		ListsCache()
+		// access list info:
+		int totalSpace() const {return M;     }
+		int numLists()   const {return N;     }
+		int numEntries() const {return nUsed; } // Objects on all lists
+		int length(int i=0) const { return i>=0 && i<N? count[i] : 0; }
+
+		// Insert to the front (end) of list #i. False (0) if full.
+		bool insert(OBJ const& o, int i = 0)      { OBJ* p = insert(i); if(p) *p = o; return p != 0; }
+		OBJ* insert(int i = 0); // Return the undefined object
+		bool insertAtEnd(OBJ const& o, int i = 0) { OBJ* p = insertAtEnd(i); if(p) *p = o; return p != 0; }
+		OBJ* insertAtEnd(int i = 0); // Return the undefined object
+
+		// delete/remove from list #i  // Must have ==(OBJ,OBJ) defined ! ! !
+		bool remove(OBJ const& o, int i = 0);
+		// locate query	in list #i
+		OBJ* locate(OBJ const& o, int i = 0);
+
+		// Cursor access (see Lists)
+		int  first(int i=0) const     { return i>=0 && i<N? list[i] : -1; }
+		int  last(int i=0) const      { return i>=0 && i<N? tail[i] : -1; }
+		int  nextOf(int k) const      { return log[k].next; }
+		OBJ&       objOf(int k)       { return log[k].obj; }
+		const OBJ& objOf(int k) const { return log[k].obj; }
+		LinkNext* getList(int i=0)    { int k = first(i); return k>=0? &log[k] : 0; }
+		LinkNext* getNext(const LinkNext& o) { return o.next>=0? &log[o.next] : 0; }
+		LinkNext* getLast(int i=0)    { int k = last(i); return k>=0? &log[k] : 0; }
+
+		// Remove all list elements
+		void clearList(int i=0)
 		{
-			for(int i = 0; i < M-1; i++)
-				log[i].next = i+1; 
-			log[M-1].next = -1;
-			available = 0;
+			int k = last(i);
+			if(k>=0) {log[k].next = avail; avail = list[i]; list[i] = tail[i] = -1; nUsed -= count[i]; count[i] = 0;}
 		}
-		// add to list index
-		bool add(int i, const OBJ o);
-		// delete/remove from list index i
-		bool del(int i, const OBJ o);
-		// locate query
-		int find(int i, const OBJ o);
+		// pop-out the 1st element on list #i
+		void popList(int i=0);
+		// pop-out the element next(after) to given LinkNext (entry j) on list #i
+		void popNext(LinkNext& o, int i) { popNext((int)(&o - log), i); }
+		void popNext(int j, int i);
 
 	private:
-		int      list[N];
-		Linked   log[M]; // an linked
-		int      available;// 
+		int       list[N];  // First entry of each list (-1: empty list)
+		int       tail[N];  // Last entry of each list
+		int       count[N]; // Objects on each list
+		LinkNext  log[M];   // Shared entries
+		int       avail;    // Free list
+		int       nUsed;    // Objects on all lists
+		int take()          { int k = avail; if(k>=0) avail = log[k].next; return k; }
+		void release(int k, int i) { log[k].next = avail; avail = k; count[i]--; nUsed--; }
 	};
 
 
-
 } // End of namespace DSA
 
 
@@ -11,19 +11,24 @@
 namespace DSA
 {
 	// A Table/Cursor Based List(Array) Implementation:
-	template<typename OBJ>
-	bool Lists<OBJ>::alloc(int maxEntry, int len)
+	template<typename OBJ, template<class> class LAYOUT>
+	bool Lists<OBJ,LAYOUT>::alloc(int maxEntry, int len)
 	{
-		if(list.alloc(len, len) && log.alloc(maxEntry, maxEntry) )
+		if(list.alloc(len, len) && tail.alloc(len, len) && count.alloc(len, len) && log.alloc(maxEntry) )
 		{
-			list = -1;
+			for(int i = 0; i < len; i++)
+			{
+				list[i] = tail[i] = -1;
+				count[i] = 0;
+			}
+			nUsed = 0;
+			if(doubly) relink();
 
-			for(int i = 0; i < log.space(); i++)
-				log[i].next = i+1;
-			//if(log.space()>0) 
-			if(log.begin()) // log must be valid 
+			for(int i = 0; i < log.len(); i++)
+				log.next(i) = i+1;
+			if(log.len() > 0)
 			{
-				log.last()->next = -1;
+				log.next(log.len()-1) = -1;
 				avail = 0;
 			}
 			else
@@ -37,99 +42,257 @@ namespace DSA
 	// M is the total number of list items reserved...
 
 	// Insert to the front of list #i: // Faster than insert to the end...
-	template<typename OBJ>
-	bool Lists<OBJ>::insert(OBJ const& o, int i)
+	template<typename OBJ, template<class> class LAYOUT>
+	bool Lists<OBJ,LAYOUT>::insert(OBJ const& o, int i)
 	{
-		if(avail < 0) growLog( log.space()+1 );
+		autoCompact();
+		if(avail < 0) growLog( log.len()+1, growth );
 
-		if(i >= 0 && i < list.len() )
+		if( avail >= 0 && i >= 0 && i < list.len() )
 		{
 			// Get avail's put infront of the existing log.
-			int nextAvail = log[avail].next;
+			int nextAvail = log.next(avail);
 
-			log[avail].obj  = o;
-			log[avail].next = list[i];
+			log.obj(avail)  = o;
+			log.next(avail) = list[i];
 
+			if(list[i] < 0) tail[i] = avail;
+			if(doubly) { setPrev(list[i], avail); prev[avail] = -1; owner[avail] = i; }
 			list[i]         = avail;
 			avail = nextAvail;
+			count[i]++;
+			nUsed++;
+			nChanged++;
 			return true;
 		}
 		return false;
 	};
 	// Similiar to above, but inserted object can be fined in a separate step.
-	template<typename OBJ>
-	OBJ* Lists<OBJ>::insert(int i)
+	template<typename OBJ, template<class> class LAYOUT>
+	OBJ* Lists<OBJ,LAYOUT>::insert(int i)
 	{
-		if(avail < 0) growLog( log.space()+1 );
+		autoCompact();
+		if(avail < 0) growLog( log.len()+1, growth );
 
-		if( i >= 0 && i < list.len() )
+		if( avail >= 0 && i >= 0 && i < list.len() )
 		{
 			// Get avail's put infront of the existing log.
-			int nextAvail = log[avail].next;
+			int nextAvail = log.next(avail);
 
-//			log[avail].obj  = o;
-			OBJ* ob = & (log[avail].obj) ; //undefined object
-			log[avail].next = list[i];
+//			log.obj(avail)  = o;
+			OBJ* ob = & (log.obj(avail)) ; //undefined object
+			log.next(avail) = list[i];
 
+			if(list[i] < 0) tail[i] = avail;
+			if(doubly) { setPrev(list[i], avail); prev[avail] = -1; owner[avail] = i; }
 			list[i]         = avail;
 			avail = nextAvail;
+			count[i]++;
+			nUsed++;
+			nChanged++;
 			return ob;
 		}
 		return 0;
 	};
 
-	template<typename OBJ>
-	bool Lists<OBJ>::insertAtEnd(OBJ const& o, int i)
+	template<typename OBJ, template<class> class LAYOUT>
+	bool Lists<OBJ,LAYOUT>::insertAtEnd(OBJ const& o, int i)
+	{
+		int k = append(i);
+		if(k < 0)
+			return false;
+		log.obj(k) = o;
+		return true;
+	};
+	// Similiar to above, but inserted object can be fined in a separate step.
+	template<typename OBJ, template<class> class LAYOUT>
+	OBJ* Lists<OBJ,LAYOUT>::insertAtEnd(int i)
 	{
-		if( avail < 0) growLog( log.space()+1 );
+		int k = append(i);
+		return k >= 0? &(log.obj(k)) : 0;
+	};
+
+	// Link a free entry after the tail of list #i; its index, or -1
+	template<typename OBJ, template<class> class LAYOUT>
+	int Lists<OBJ,LAYOUT>::append(int i)
+	{
+		autoCompact();
+		if(avail < 0) growLog( log.len()+1, growth );
+
+		if( avail < 0 || i < 0 || i >= list.len() )
+			return -1;
+		int k = avail;
+		avail = log.next(k);
+		log.next(k) = -1;
+
+		// Register the new object after the tail
+		if(tail[i] >= 0)
+			log.next(tail[i]) = k;
+		else
+			list[i] = k;
+		if(doubly) { prev[k] = tail[i]; owner[k] = i; }
+		tail[i] = k;
+		count[i]++;
+		nUsed++;
+		nChanged++;
+		return k;
+	}
 
-		if( i >= 0 && i < list.len() )
+	template<typename OBJ, template<class> class LAYOUT>
+	bool Lists<OBJ,LAYOUT>::splice(int i, int j)
+	{
+		if( i < 0 || i >= list.len() || j < 0 || j >= list.len() )
+			return false;
+		if( i == j || list[j] < 0 )
+			return true;
+		if(tail[i] >= 0)
+			log.next(tail[i]) = list[j];
+		else
+			list[i] = list[j];
+		if(doubly)
 		{
-			// Get to the last
-			LinkNext* p = getLast(i);
-			// Register the new object's starting point
-			if(p)
-				p->next = avail;
-			else
-				list[i] = avail;
+			prev[list[j]] = tail[i];
+			for(int k = list[j]; k >= 0; k = log.next(k))
+				owner[k] = i;
+		}
+		tail[i] = tail[j];
+		count[i] += count[j];
+		list[j] = tail[j] = -1;
+		count[j] = 0;
+		return true;
+	}
 
-			// Update log
-			int nextAvail = log[avail].next;
-			log[avail].obj  = o;
-			log[avail].next = -1;
-			avail = nextAvail;
+	template<typename OBJ, template<class> class LAYOUT>
+	template<typename Pred>
+	int Lists<OBJ,LAYOUT>::splitList(int i, int j, Pred moves)
+	{
+		if( i < 0 || i >= list.len() || j < 0 || j >= list.len() || i == j )
+			return 0;
+		int n = 0, p = -1; // p: last object kept on list #i
+		for(int k = list[i]; k >= 0; )
+		{
+			int nx = log.next(k);
+			if( moves(log.obj(k)) )
+			{
+				if(p >= 0) log.next(p) = nx;
+				else       list[i] = nx;
+				setPrev(nx, p);
+
+				log.next(k) = -1;
+				if(tail[j] >= 0) log.next(tail[j]) = k;
+				else             list[j] = k;
+				if(doubly) { prev[k] = tail[j]; owner[k] = j; }
+				tail[j] = k;
+				n++;
+			}
+			else
+				p = k;
+			k = nx;
 		}
-		return false;
-	};
-	// Similiar to above, but inserted object can be fined in a separate step.
-	template<typename OBJ>
-	OBJ* Lists<OBJ>::insertAtEnd(int i)
+		tail[i] = p;
+		count[i] -= n;
+		count[j] += n;
+		return n;
+	}
+
+	template<typename OBJ, template<class> class LAYOUT>
+	bool Lists<OBJ,LAYOUT>::resizeLists(int len)
 	{
-		if(avail < 0) growLog( log.space()+1 );
+		int n = list.len();
+		for(int i = len; i < n; i++)
+			if( list[i] >= 0 )
+				return false;
+		if( len < 0 || !(list.resize(len) && tail.resize(len) && count.resize(len)) )
+			return false;
+		for(int i = n; i < len; i++)
+		{
+			list[i] = tail[i] = -1;
+			count[i] = 0;
+		}
+		return true;
+	}
 
-		if( i >= 0 && i < list.len() )
+	template<typename OBJ, template<class> class LAYOUT>
+	bool Lists<OBJ,LAYOUT>::buildFrom(const OBJ* objs, const int* listIds, int n)
+	{
+		int nList = list.len();
+
+		// Objects per list and per part of the input (checking the list ids); each
+		// part then places its objects of list #i after those of the previous parts
+		// (stable). An object costs only a count and a copy, so a part takes a
+		// thread only from 8*ParallelMinWork objects: below, one thread is faster.
+		int np = numThreadsFor(n, 8L*ParallelMinWork + nList);
+		Array<int> at, bad;
+		if( ! at.alloc(np*nList) || ! bad.alloc(np) )
+			return false;
+		parallelRun(np, [&](int p, int np)
 		{
-			// Get to the last
-			LinkNext* p = getLast(i);
-			// Register the new object's starting point
-			if(p)
-				p->next = avail;
-			else
-				list[i] = avail;
+			int* c = at.begin() + p*nList;
+			for(int i = 0; i < nList; i++) c[i] = 0;
+			bad[p] = 0;
+			for(int k = (int)((long)n*p/np), e = (int)((long)n*(p+1)/np); k < e; k++)
+			{
+				int i = listIds[k];
+				if( i < 0 || i >= nList ) { bad[p] = 1; break; }
+				c[i]++;
+			}
+		});
+		for(int p = 0; p < np; p++)
+			if( bad[p] )
+				return false;
+		if( n > log.len() )
+		{
+			// The old contents are dropped: no need to keep them while growing
+			for(int i = 0; i < nList; i++)
+				list[i] = tail[i] = -1;
+			avail = -1;
+			Storage empty;
+			log.swap(empty);
+			if( ! growLog(n, 1.0f) )
+				return false;
+		}
 
-			// Update log
-			int nextAvail = log[avail].next;
-//			log[avail].obj  = o;
-			log[avail].next = -1;
-			avail = nextAvail;
-			return &(log[avail].obj);
+		int pos = 0;
+		for(int i = 0; i < nList; i++)
+		{
+			count[i] = 0;
+			for(int p = 0; p < np; p++)
+			{
+				int c = at[p*nList+i];
+				at[p*nList+i] = pos;
+				pos += c;
+				count[i] += c;
+			}
+			list[i] = count[i] > 0? pos-count[i] : -1;
+			tail[i] = count[i] > 0? pos-1 : -1;
 		}
-		return 0;
-	};
+		parallelRun(np, [&](int p, int np)
+		{
+			int* c = at.begin() + p*nList;
+			for(int k = (int)((long)n*p/np), e = (int)((long)n*(p+1)/np); k < e; k++)
+			{
+				int j = c[listIds[k]]++;
+				log.obj(j)  = objs[k];
+				log.next(j) = j+1;
+			}
+		});
+		for(int i = 0; i < nList; i++)
+			if( tail[i] >= 0 ) log.next(tail[i]) = -1;
+
+		// Free entries after the objects
+		int len = log.len();
+		for(int j = n; j < len; j++)
+			log.next(j) = j+1 < len? j+1 : -1;
+		avail = n < len? n : -1;
+		nUsed = n;
+		nChanged = 0;
+		if(doubly) relink();
+		return true;
+	}
 
 	// delete/remove from list index i
-	template<typename OBJ>
-	bool Lists<OBJ>::remove(OBJ const& o, int i)
+	template<typename OBJ, template<class> class LAYOUT>
+	bool Lists<OBJ,LAYOUT>::remove(OBJ const& o, int i)
 	{
 		if( i < 0 || i >= list.len())
 			return false;
@@ -138,23 +301,33 @@ namespace DSA
 
 		int j = list[i];
 		// Check the first one.
-		if(log[j].obj == o)
+		if(log.obj(j) == o)
 		{
-			list[i] = log[j].next;   // parent->grandchild
-			log[j].next = avail;	 // update avail
+			list[i] = log.next(j);   // parent->grandchild
+			if(list[i] < 0) tail[i] = -1;
+			setPrev(list[i], -1);
+			log.next(j) = avail;	 // update avail
 			avail = j;
+			count[i]--;
+			nUsed--;
+			nChanged++;
 			return true;
 		}
 		else
 		{
 			// Find the one whose next is o
-			while( log[j].next >= 0 && !(log[log[j].next].obj == o) ) j= log[j].next;
-			if(j>=0)
+			while( log.next(j) >= 0 && !(log.obj(log.next(j)) == o) ) j= log.next(j);
+			if(log.next(j)>=0)
 			{
-				int k = log[j].next;
-				log[j].next = log[k].next;   // parent->grandchild
-				log[k].next = avail;		 // update avail
+				int k = log.next(j);
+				log.next(j) = log.next(k);   // parent->grandchild
+				if(tail[i] == k) tail[i] = j;
+				setPrev(log.next(j), j);
+				log.next(k) = avail;		 // update avail
 				avail = k;
+				count[i]--;
+				nUsed--;
+				nChanged++;
 				return true;
 			}
 		}
@@ -162,39 +335,24 @@ namespace DSA
 	}
 
 	// locate query
-	template<typename OBJ>
-	OBJ*  Lists<OBJ>::locate(OBJ  const& o, int i)
+	template<typename OBJ, template<class> class LAYOUT>
+	OBJ*  Lists<OBJ,LAYOUT>::locate(OBJ  const& o, int i)
 	{
-		LinkNext* np = getList(i);
-		while(np)
+		for( int k = first(i); k >= 0; k = log.next(k))
 		{
-			if( np->obj == o)
+			if( log.obj(k) == o)
 			{
-				return &(np->obj); // found the match
+				return &(log.obj(k)); // found the match
 			}
-			np = getNext(*np);
 		};
 		return 0; // No match
 	}
 
-	// Get the last object on list #i. Null on empty list.
-	template<typename OBJ>
-	typename Lists<OBJ>::LinkNext* Lists<OBJ>::getLast(int i)
-	{
-		Lists<OBJ>::LinkNext* np = getList(i);
-		while(np)
-		{
-			if(np->next < 0) return np;
-			np = getNext(*np);
-		};
-		return 0;
-	}
-
 	// Get the object in front of the given object
-//	template<typename OBJ>
-//	typename Lists<OBJ>::LinkNext* Lists<OBJ>::getInFrontOf(const OBJ &o, int i)
+//	template<typename OBJ, template<class> class LAYOUT>
+//	typename Lists<OBJ,LAYOUT>::LinkNext* Lists<OBJ,LAYOUT>::getInFrontOf(const OBJ &o, int i)
 //	{
-//		Lists<OBJ>::LinkNext* np = getList(i);
+//		Lists<OBJ,LAYOUT>::LinkNext* np = getList(i);
 //		while(np && np->next >= 0)
 //		{
 //			if(log[np->next]==o) return np;
@@ -203,129 +361,372 @@ namespace DSA
 //		return 0;
 //	}
 
-	// Count
-	template<typename OBJ>
-	int Lists<OBJ>::length(int i)
+	// Grow the storage to n entries, or "factor" times the current ones if more.
+	// The new entries go in front of the free list.
+	template<typename OBJ, template<class> class LAYOUT>
+	bool Lists<OBJ,LAYOUT>::growLog(int n, float factor)
 	{
-		int cnt = 0;
-		LinkNext* np = getList(i);
-		while(np)
+		int nOld = log.len();
+		if( n <= nOld )
+			return true;
+		float target = nOld*factor;
+		if( target > n )
+			n = target < 2147483647.0f? (int)target : 2147483647;
+		if( n < 16 )
+			n = 16;
+
+		// Copy into a new block: the storage is reallocated once per growth step
+		Storage grown;
+		if( ! grown.alloc(n) )
+			return false;
+		for( int i = 0; i < nOld; i++)
 		{
-			cnt++;
-			np = getNext(*np);
-		};
-		return cnt;
+			grown.next(i) = log.next(i);
+			grown.obj(i)  = log.obj(i);
+		}
+		log.swap(grown);
+		if( doubly && !(prev.resize(n) && owner.resize(n)) )
+			return false;
+
+		for( int i = nOld; i < n-1; i++)
+			log.next(i) = i+1;
+		log.next(n-1) = avail;
+		avail = nOld;
+		return true;
 	}
 
-	template<typename OBJ>
-	int Lists<OBJ>::growLog(int n)
+	template<typename OBJ, template<class> class LAYOUT>
+	bool Lists<OBJ,LAYOUT>::compact()
 	{
-		// TBD>>> 11/22/09:
-		// If there is enough space left already.
-		if ( n <= log.spaceLeft() )
-			return 0;
+		int n = log.len();
+		if( n == 0 )
+			return true;
+		Storage packed;
+		if( ! packed.alloc(n) )
+			return false;
 
-		int nOld = log.len();
+		// Copy the lists one after the other, each in order
+		int k = 0;
+		for( int i = 0; i < list.len(); i++)
+		{
+			if( list[i] < 0 )
+				continue;
+			int first = k;
+			for( int j = list[i]; j >= 0; j = log.next(j), k++)
+			{
+				packed.obj(k)  = log.obj(j);
+				packed.next(k) = k+1;
+			}
+			packed.next(k-1) = -1;
+			list[i] = first;
+			tail[i] = k-1;
+		}
+		// Then the free entries
+		for( int j = k; j < n-1; j++)
+			packed.next(j) = j+1;
+		if( k < n )
+			packed.next(n-1) = -1;
+		avail = k < n? k : -1;
+
+		log.swap(packed);
+		nChanged = 0;
+		if(doubly) relink();
+		return true;
+	}
 
-		if( log.grow(n) )
+	template<typename OBJ, template<class> class LAYOUT>
+	float Lists<OBJ,LAYOUT>::fragmentation() const
+	{
+		int nLink = 0, nJump = 0;
+		for( int i = 0; i < list.len(); i++)
+			for( int j = list[i]; j >= 0 && log.next(j) >= 0; j = log.next(j))
+			{
+				nLink++;
+				if( log.next(j) != j+1 ) nJump++;
+			}
+		return nLink > 0? (float)nJump/nLink : 0.0f;
+	}
+
+	// Doubly-linked mode
+	template<typename OBJ, template<class> class LAYOUT>
+	void Lists<OBJ,LAYOUT>::setDoublyLinked(bool on)
+	{
+		doubly = on;
+		if(doubly)
+			relink();
+		else
 		{
-			int nLast = log.space()-1;
-//			for( int i = nOld; i < log.space(); i++)
-			for( int i = nOld; i < nLast; i++)
-				log[i].next = i+1;
-//			if(log.begin())
-			if(nLast>=0) 
-				log[nLast].next = -1;
-//				log.last()->next = -1;
-			
-			if(avail < 0)
+			prev.resize(0);
+			owner.resize(0);
+		}
+	}
+
+	template<typename OBJ, template<class> class LAYOUT>
+	void Lists<OBJ,LAYOUT>::relink()
+	{
+		int n = log.len();
+		prev.resize(n);
+		owner.resize(n);
+		for(int i = 0; i < list.len(); i++)
+			for(int p = -1, k = list[i]; k >= 0; p = k, k = log.next(k))
 			{
-				avail = nOld; //New avail...
+				prev[k]  = p;
+				owner[k] = i;
 			}
-			else
+	}
+
+	template<typename OBJ, template<class> class LAYOUT>
+	void Lists<OBJ,LAYOUT>::unlink(int h)
+	{
+		int i = owner[h], p = prev[h], n = log.next(h);
+		if(p >= 0) log.next(p) = n; else list[i] = n;
+		if(n >= 0) prev[n] = p;     else tail[i] = p;
+		log.next(h) = avail;
+		avail = h;
+		count[i]--;
+		nUsed--;
+		nChanged++;
+	}
+
+	template<typename OBJ, template<class> class LAYOUT>
+	void Lists<OBJ,LAYOUT>::moveToFront(int h)
+	{
+		int i = owner[h], p = prev[h], n = log.next(h);
+		if(p < 0)
+			return; // Already in front
+		log.next(p) = n;
+		if(n >= 0) prev[n] = p; else tail[i] = p;
+		log.next(h) = list[i];
+		prev[list[i]] = h;
+		prev[h] = -1;
+		list[i] = h;
+	}
+
+	template<typename OBJ, template<class> class LAYOUT>
+	int Lists<OBJ,LAYOUT>::insertAfter(int h, OBJ const& o)
+	{
+		if(avail < 0) growLog( log.len()+1, growth );
+		if(avail < 0)
+			return -1;
+		int i = owner[h], n = log.next(h), k = avail;
+		avail = log.next(k);
+		log.obj(k)  = o;
+		log.next(k) = n;
+		log.next(h) = k;
+		prev[k]  = h;
+		owner[k] = i;
+		if(n >= 0) prev[n] = k; else tail[i] = k;
+		count[i]++;
+		nUsed++;
+		nChanged++;
+		return k;
+	}
+
+	// Unrolled lists
+	template<typename OBJ, int K>
+	bool UnrolledLists<OBJ,K>::alloc(int maxEntry, int len)
+	{
+		if( ! blocks.alloc((maxEntry+K-1)/K, len) || ! nUsed.alloc(len, len) )
+			return false;
+		for(int i = 0; i < len; i++)
+			nUsed[i] = 0;
+		return true;
+	}
+
+	template<typename OBJ, int K>
+	bool UnrolledLists<OBJ,K>::insert(OBJ const& o, int i)
+	{
+		if( i < 0 || i >= nUsed.len() )
+			return false;
+		int k = blocks.first(i);
+		Block* b = k >= 0 && blocks.objOf(k).n < K? &blocks.objOf(k) : 0;
+		if( b == 0 )
+		{
+			b = blocks.insert(i);
+			if( b == 0 )
+				return false;
+			b->n = 0;
+		}
+		for(int j = b->n; j > 0; j--)
+			b->obj[j] = b->obj[j-1];
+		b->obj[0] = o;
+		b->n++;
+		nUsed[i]++;
+		return true;
+	}
+
+	template<typename OBJ, int K>
+	bool UnrolledLists<OBJ,K>::insertAtEnd(OBJ const& o, int i)
+	{
+		if( i < 0 || i >= nUsed.len() )
+			return false;
+		int k = blocks.last(i);
+		Block* b = k >= 0 && blocks.objOf(k).n < K? &blocks.objOf(k) : 0;
+		if( b == 0 )
+		{
+			b = blocks.insertAtEnd(i);
+			if( b == 0 )
+				return false;
+			b->n = 0;
+		}
+		b->obj[b->n++] = o;
+		nUsed[i]++;
+		return true;
+	}
+
+	template<typename OBJ, int K>
+	bool UnrolledLists<OBJ,K>::remove(OBJ const& o, int i)
+	{
+		for(int prev = -1, k = blocks.first(i); k >= 0; prev = k, k = blocks.nextOf(k))
+		{
+			Block& b = blocks.objOf(k);
+			for(int j = 0; j < b.n; j++)
 			{
-				int nAvail = avail;
-				while( nAvail >= 0 && nAvail < nOld && log[nAvail].next >= 0 )
+				if( !(b.obj[j] == o) )
+					continue;
+				for(b.n--; j < b.n; j++)
+					b.obj[j] = b.obj[j+1];
+				if( b.n == 0 )
 				{
-					nAvail = log[nAvail].next;
+					if( prev < 0 ) blocks.popList(i);
+					else           blocks.popNext(prev, i);
 				}
-				log[nAvail].next = nOld;
+				nUsed[i]--;
+				return true;
 			}
 		}
-		return n;
+		return false;
+	}
+
+	template<typename OBJ, int K>
+	OBJ* UnrolledLists<OBJ,K>::locate(OBJ const& o, int i)
+	{
+		for(int k = blocks.first(i); k >= 0; k = blocks.nextOf(k))
+		{
+			Block& b = blocks.objOf(k);
+			for(int j = 0; j < b.n; j++)
+				if( b.obj[j] == o )
+					return &b.obj[j];
+		}
+		return 0;
+	}
+
+	template<typename OBJ, int K>
+	template<typename Lambda>
+	void UnrolledLists<OBJ,K>::forEach(int i, Lambda f)
+	{
+		for(int k = blocks.first(i); k >= 0; k = blocks.nextOf(k))
+		{
+			Block& b = blocks.objOf(k);
+			for(int j = 0; j < b.n; j++)
+				f(b.obj[j]);
+		}
 	}
 
 	// Cache Version:
 	// N is the number of list. OBJ is the type of list objects.
 	// M is the total number of list items reserved...
 	template<int N, typename OBJ, int M>
-	bool ListsCache<N, OBJ, M>::add(int i, const OBJ o)
+	void ListsCache<N, OBJ, M>::clear()
 	{
-		if(list[i] < 0)
+		for(int i = 0; i < N; i++)
 		{
-			if(available >= 0)
-			{
-				list[i] = available;
-				log[available].obj = o;
-				available = log[available].next;
-				log[available].next = -1;
-				return true;
-			}
-			return false;
+			list[i] = tail[i] = -1;
+			count[i] = 0;
 		}
+		for(int k = 0; k < M; k++)
+			log[k].next = k+1 < M? k+1 : -1;
+		avail = M > 0? 0 : -1;
+		nUsed = 0;
+	}
+
+	template<int N, typename OBJ, int M>
+	OBJ* ListsCache<N, OBJ, M>::insert(int i)
+	{
+		if( i < 0 || i >= N )
+			return 0;
+		int k = take();
+		if( k < 0 )
+			return 0;
+		log[k].next = list[i];
+		if(list[i] < 0) tail[i] = k;
+		list[i] = k;
+		count[i]++;
+		nUsed++;
+		return &log[k].obj;
+	}
+
+	template<int N, typename OBJ, int M>
+	OBJ* ListsCache<N, OBJ, M>::insertAtEnd(int i)
+	{
+		if( i < 0 || i >= N )
+			return 0;
+		int k = take();
+		if( k < 0 )
+			return 0;
+		log[k].next = -1;
+		if(tail[i] >= 0)
+			log[tail[i]].next = k;
 		else
-		{
-			int j = i;
-			while(j >= 0 && list[j].next > 0) j = list[j].next;
-			list[j].next = available;						   //TBD TBD.. TBD... 
-			log[available].obj = o;
-			available = log[available].next;
-			log[available].next = -1;
-			return true;
-		}
-		return false;
-	};
-		// delete/remove from list index i
+			list[i] = k;
+		tail[i] = k;
+		count[i]++;
+		nUsed++;
+		return &log[k].obj;
+	}
+
+	// delete/remove from list index i
 	template<int N, typename OBJ, int M>
-	bool ListsCache<N, OBJ, M>::del(int i, const OBJ o)
+	bool ListsCache<N, OBJ, M>::remove(OBJ const& o, int i)
 	{
-		if(list[i] < 0) 
+		if( i < 0 || i >= N || list[i] < 0 )
 			return false;
-
-		int j = list[i];
-		// Check the first one.
-		if(log[j].next < 0 && log[j].obj == o)
+		if( log[list[i]].obj == o )
 		{
-			list[i] = -1;
-			log[j].next = available;
-			available = j;
+			popList(i);
 			return true;
 		}
-		else
-		{
-			// Find the one whose next is o
-			while( log[j].next>=0 && log[log[j].next].obj != o ) j= list[j].next;
-			if(log[j].next>=0)
+		// Find the one whose next is o
+		for(int j = list[i]; log[j].next >= 0; j = log[j].next)
+			if( log[log[j].next].obj == o )
 			{
-				int k = log[j].next;
-				log[j].next = log[k].next;
-				log[j].next = available;
-				available = k;
+				popNext(j, i);
 				return true;
 			}
-		}
 		return false;
 	}
-		// locate query
+
+	// locate query
 	template<int N, typename OBJ, int M>
-	int ListsCache<N, OBJ, M>::find(int i, const OBJ o)
+	OBJ* ListsCache<N, OBJ, M>::locate(OBJ const& o, int i)
 	{
-		int j = list[i];
-		while( j>=0 && log[j].obj != o ) j= log[j].next;
-		return j;
+		for(int k = first(i); k >= 0; k = log[k].next)
+			if( log[k].obj == o )
+				return &log[k].obj;
+		return 0;
 	}
 
+	template<int N, typename OBJ, int M>
+	void ListsCache<N, OBJ, M>::popList(int i)
+	{
+		int k = first(i);
+		if( k < 0 )
+			return;
+		list[i] = log[k].next;
+		if(list[i] < 0) tail[i] = -1;
+		release(k, i);
+	}
 
+	template<int N, typename OBJ, int M>
+	void ListsCache<N, OBJ, M>::popNext(int j, int i)
+	{
+		int k = i >= 0 && i < N? log[j].next : -1;
+		if( k < 0 )
+			return;
+		log[j].next = log[k].next;
+		if(tail[i] == k) tail[i] = j;
+		release(k, i);
+	}
 
 } // End of namespace DSA
 
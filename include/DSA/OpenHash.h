@@ -0,0 +1,130 @@
+// ================= DSA DLL Files =====================
+// File: OpenHash.h
+// Open-addressing hash table with the interface of Hash<L,C>.
+// =======================================================
+// Note:
+// OpenHash<L,C> stores its entries in one array of slots, without chains.
+// Every slot has a control byte: empty, deleted, or 7 bits of the entry's hash.
+// The slots are probed in groups of 16: the 16 control bytes of a group are
+// compared with the key's 7 bits at once (one SSE2 compare on x86-64), and only
+// the slots that match are compared with the key, so a lookup usually touches
+// one group of control bytes and one entry. Groups are probed quadratically.
+//
+// The table grows (doubling) when it is 7/8 full, so it never fills up; the
+// slot count is a power of two. Adding an entry may move the others: pointers
+// returned by add()/find() are valid until the next add.
+//
+// Hash and matching are the policies of Hash<L,C> (see Hash.h), called inline
+// in the probe loop; the top bits of the 64-bit hash pick the group and the
+// control bits, so a HASHER must mix its whole input. With the default policies
+// a Hash<L,C> of the same constructor arguments can be replaced by an OpenHash:
+//     OpenHash<int, C> table;                         // HashOf<int>, ==
+//     OpenHash<Key, C> keys(&hashing, &matching, 64); // Key: no built-in hash
+//     OpenHash<int, C, HashFunction<int>, MatchFunction<int> > f(&hashing, &matching, 64);
+//
+
+#ifndef DSA_OPENHASH_H
+#define DSA_OPENHASH_H
+#include <DSA/DSA.h>
+#include <DSA/Array.h>
+#include <DSA/Hash.h>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace DSA
+{
+	template<class L, class C, class HASHER = DefaultHash<L>, class EQUAL = DefaultEqual<L> >
+	class OpenHash
+	{
+	public:
+		typedef HASHER Hashing;
+		typedef EQUAL  Matching; // Matching function for labels
+		typedef HashEntry<L,C> Entry;
+
+	public:
+		// Constructors:
+		OpenHash(Hashing f = Hashing(), Matching m = Matching()) : hash(f), match(m) { allocate(0); }
+		// Room for nEntryMax entries before the table grows. hashSize is a minimum
+		// number of slots (rounded up to a power of two).
+		OpenHash(Hashing f, Matching m, int nEntryMax, unsigned int hashSize = 0) : hash(f), match(m)
+		{ allocate(nEntryMax, hashSize); }
+		virtual ~OpenHash() {}
+
+		// Empty the table, with room for nMaxEntry entries (and hashSize slots)
+		bool allocate(int nMaxEntry, unsigned int hashSize = 0);
+
+		// Access hash table size
+		int getNumMaxEntry() const { return nSlot - nSlot/8; }  // Entries before growing
+		int getNumEntries() const  { return nUsed; }
+		int getHashSize() const    { return nSlot; }
+		unsigned int hashSize() const { return nSlot; }
+
+		// Add one label, leaving content to be defined later. If the key matches an
+		// existing entry, the matched entry is returned.
+		Entry* add(L const& key);
+		// Insert (label, content). Duplicated label will replace the content.
+		bool add(L const& key, C const& content);
+		// Add one entry. Entries with the same labels are logged regardless.
+		bool add(Entry const& ent);
+
+		// Delete one entry (by label); false if there is no match
+		bool del(L const& key);
+
+		// Find entry whose label matches the given "key"; NULL if none
+		Entry* find(L const& key);
+		C*     operator[](L const& key) { Entry* found = find(key); return found? &found->content : 0; }
+		// Find the content whose label matches the given "key"
+		C* findContent(L const& key)    { return (*this)[key]; }
+		// All entries whose label matches the given "key"
+		bool findAll(L const& key, Array<Entry>& res);
+
+		// Slot of an entry whose hash bits equal those of the key (a possible
+		// collision; find() tells if it is the same key). -1 if none.
+		int collision(L const& key);
+
+	protected:
+		enum
+		{
+			Group   = 16,   // Slots probed together
+			Empty   = 0x80, // Control bytes; a full slot holds 7 hash bits
+			Deleted = 0xFE
+		};
+
+		Array<UChar>  ctrl;     // Control byte of every slot
+		Array<Entry>  slot;     // Entries
+		int           nSlot;    // Number of slots (power of two, multiple of Group)
+		int           nUsed;    // Full slots
+		int           nDeleted; // Deleted slots (tombstones)
+
+		// Hash of a key over 64 bits; group and control bits come from it
+		inline ULongLong hashOf(L const& key) const { return hash(key); }
+		inline int   groupOf(ULongLong h) const { return (int)((ULong)(h >> 32) & (ULong)(nSlot/Group - 1)); }
+		static inline UChar tagOf(ULongLong h)  { return (UChar)(h >> 57); }
+		// Bit j set if control byte j of a group equals b
+		static inline unsigned matchByte(const UChar* g, UChar b);
+		// Bit j set if slot j of a group is empty or deleted
+		static inline unsigned matchFree(const UChar* g);
+		static inline int lowBit(unsigned m);
+
+		// Slot of the entry matching key, or -1
+		int  findSlot(L const& key, ULongLong h) const;
+		// A free slot for a new entry of hash h (the table has room)
+		int  freeSlot(ULongLong h) const;
+		// Make room for one more entry
+		bool reserveOne();
+		bool rehash(int newSlots);
+
+	private:
+		HASHER       hash;   // hash function
+		EQUAL        match;	 // match function
+	};
+
+} // End of namespace DSA
+
+#include <DSA/OpenHash.inl>
+
+#endif
@@ -0,0 +1,258 @@
+// ================= DSA DLL Files =====================
+// File: OpenHash.inl
+// =======================================================
+// Note:
+//
+#ifndef DSA_OPENHASH_INL
+#define DSA_OPENHASH_INL
+
+/*==========================================================================*\
+**				Non-inline template function definitions					**
+\*==========================================================================*/
+
+namespace DSA
+{
+	template<class L, class C, class HASHER, class EQUAL>
+	inline unsigned OpenHash<L,C,HASHER,EQUAL>::matchByte(const UChar* g, UChar b)
+	{
+#if defined(__SSE2__) || defined(_M_X64)
+		__m128i v = _mm_loadu_si128((const __m128i*)g);
+		return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)b)));
+#else
+		unsigned m = 0;
+		for (int j = 0; j < Group; ++j)
+			if( g[j] == b ) m |= 1u << j;
+		return m;
+#endif
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	inline unsigned OpenHash<L,C,HASHER,EQUAL>::matchFree(const UChar* g)
+	{
+#if defined(__SSE2__) || defined(_M_X64)
+		// Empty and Deleted are the control bytes with the high bit set
+		return (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)g));
+#else
+		unsigned m = 0;
+		for (int j = 0; j < Group; ++j)
+			if( g[j] & 0x80 ) m |= 1u << j;
+		return m;
+#endif
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	inline int OpenHash<L,C,HASHER,EQUAL>::lowBit(unsigned m)
+	{
+#if defined(_MSC_VER)
+		unsigned long j;
+		_BitScanForward(&j, m);
+		return (int)j;
+#else
+		return __builtin_ctz(m);
+#endif
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	bool OpenHash<L,C,HASHER,EQUAL>::allocate(int nMaxEntry, unsigned int hashSize)
+	{
+		// Slots for nMaxEntry at 7/8 load, a power of two of at least one group
+		long need = (long)nMaxEntry + nMaxEntry/7 + 1;
+		if( need < (long)hashSize ) need = hashSize;
+		int n = Group;
+		while( n < need && n < (1 << 30) )
+			n <<= 1;
+		if( ! ctrl.alloc(n) || ! slot.alloc(n) )
+			return false;
+		for (int j = 0; j < n; ++j)
+			ctrl[j] = Empty;
+		nSlot    = n;
+		nUsed    = 0;
+		nDeleted = 0;
+		return true;
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	int OpenHash<L,C,HASHER,EQUAL>::findSlot(L const& key, ULongLong h) const
+	{
+		int mask = nSlot/Group - 1, g = groupOf(h);
+		UChar tag = tagOf(h);
+		for (int i = 1; i <= nSlot/Group; ++i)
+		{
+			const UChar* c = ctrl.begin() + g*Group;
+			for (unsigned m = matchByte(c, tag); m; m &= m-1)
+			{
+				int j = g*Group + lowBit(m);
+				if( match(slot[j].label, key) )
+					return j;
+			}
+			if( matchByte(c, Empty) ) // The key would have been placed here
+				return -1;
+			g = (g + i) & mask; // Triangular steps visit every group
+		}
+		return -1;
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	int OpenHash<L,C,HASHER,EQUAL>::freeSlot(ULongLong h) const
+	{
+		int mask = nSlot/Group - 1, g = groupOf(h);
+		for (int i = 1; ; ++i)
+		{
+			unsigned m = matchFree(ctrl.begin() + g*Group);
+			if( m )
+				return g*Group + lowBit(m);
+			g = (g + i) & mask;
+		}
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	bool OpenHash<L,C,HASHER,EQUAL>::reserveOne()
+	{
+		if( nUsed + nDeleted < getNumMaxEntry() )
+			return true;
+		// Mostly tombstones: clean up at the same size; otherwise double
+		return rehash(nUsed < getNumMaxEntry()/2? nSlot : nSlot*2);
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	bool OpenHash<L,C,HASHER,EQUAL>::rehash(int newSlots)
+	{
+		Array<UChar> oldCtrl;
+		Array<Entry> oldSlot;
+		oldCtrl.swap(ctrl);
+		oldSlot.swap(slot);
+		int n = nSlot;
+		if( ! ctrl.alloc(newSlots) || ! slot.alloc(newSlots) )
+		{
+			ctrl.swap(oldCtrl);
+			slot.swap(oldSlot);
+			return false;
+		}
+		for (int j = 0; j < newSlots; ++j)
+			ctrl[j] = Empty;
+		nSlot    = newSlots;
+		nDeleted = 0;
+		for (int j = 0; j < n; ++j)
+		{
+			if( oldCtrl[j] & 0x80 )
+				continue;
+			ULongLong h = hashOf(oldSlot[j].label);
+			int k = freeSlot(h);
+			ctrl[k] = tagOf(h);
+			slot[k] = oldSlot[j];
+		}
+		return true;
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	typename OpenHash<L,C,HASHER,EQUAL>::Entry* OpenHash<L,C,HASHER,EQUAL>::add(L const& key)
+	{
+		ULongLong h = hashOf(key);
+		int j = findSlot(key, h);
+		if( j >= 0 )
+			return &slot[j];
+		if( ! reserveOne() )
+			return 0;
+		j = freeSlot(h);
+		if( ctrl[j] == Deleted ) nDeleted--;
+		ctrl[j] = tagOf(h);
+		nUsed++;
+		slot[j] = Entry();
+		slot[j].label = key;
+		return &slot[j];
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	bool OpenHash<L,C,HASHER,EQUAL>::add(L const& key, C const& content)
+	{
+		Entry* ent = add(key);
+		if( ent )
+			ent->content = content;
+		return ent != 0;
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	bool OpenHash<L,C,HASHER,EQUAL>::add(Entry const& ent)
+	{
+		if( ! reserveOne() )
+			return false;
+		ULongLong h = hashOf(ent.label);
+		int j = freeSlot(h);
+		if( ctrl[j] == Deleted ) nDeleted--;
+		ctrl[j] = tagOf(h);
+		nUsed++;
+		slot[j] = ent;
+		return true;
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	bool OpenHash<L,C,HASHER,EQUAL>::del(L const& key)
+	{
+		int j = findSlot(key, hashOf(key));
+		if( j < 0 )
+			return false;
+		// A group with an empty slot ends every probe that reaches it, so the slot
+		// can be emptied; otherwise probes must go on past it (tombstone).
+		if( matchByte(ctrl.begin() + (j/Group)*Group, Empty) )
+			ctrl[j] = Empty;
+		else
+		{
+			ctrl[j] = Deleted;
+			nDeleted++;
+		}
+		slot[j] = Entry();
+		nUsed--;
+		return true;
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	typename OpenHash<L,C,HASHER,EQUAL>::Entry* OpenHash<L,C,HASHER,EQUAL>::find(L const& key)
+	{
+		int j = findSlot(key, hashOf(key));
+		return j >= 0? &slot[j] : NULL;
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	bool OpenHash<L,C,HASHER,EQUAL>::findAll(L const& key, Array<Entry>& res)
+	{
+		res.resize(0);
+		ULongLong h = hashOf(key);
+		int mask = nSlot/Group - 1, g = groupOf(h);
+		UChar tag = tagOf(h);
+		for (int i = 1; i <= nSlot/Group; ++i)
+		{
+			const UChar* c = ctrl.begin() + g*Group;
+			for (unsigned m = matchByte(c, tag); m; m &= m-1)
+			{
+				int j = g*Group + lowBit(m);
+				if( match(slot[j].label, key) )
+					res.append(slot[j]);
+			}
+			if( matchByte(c, Empty) )
+				break;
+			g = (g + i) & mask;
+		}
+		return res.len()>0;
+	}
+
+	template<class L, class C, class HASHER, class EQUAL>
+	int OpenHash<L,C,HASHER,EQUAL>::collision(L const& key)
+	{
+		ULongLong h = hashOf(key);
+		int mask = nSlot/Group - 1, g = groupOf(h);
+		UChar tag = tagOf(h);
+		for (int i = 1; i <= nSlot/Group; ++i)
+		{
+			const UChar* c = ctrl.begin() + g*Group;
+			unsigned m = matchByte(c, tag);
+			if( m )
+				return g*Group + lowBit(m);
+			if( matchByte(c, Empty) )
+				break;
+			g = (g + i) & mask;
+		}
+		return -1;            // No collision
+	}
+
+}// End of namespace DSA
+#endif
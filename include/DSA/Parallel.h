@@ -0,0 +1,76 @@
+// ================= DSA DLL Files =====================
+// File: Parallel.h
+// Fork-join helpers shared by the parallel kernels (SpMV, stencils, reductions).
+// =======================================================
+// Note:
+// Work is split into contiguous chunks, one per thread; the calling thread
+// runs the first chunk itself. Kernels fall back to a plain loop when the work
+// is smaller than ParallelMinWork, so small arrays never pay for threads.
+//
+
+#ifndef DSA_PARALLEL_H
+#define DSA_PARALLEL_H
+#include <DSA/DSA.h>
+#include <thread>
+
+namespace DSA
+{
+	enum
+	{
+		ParallelMinWork = 1<<15 // Minimum elements (or non-zeros) worth one more thread
+	};
+
+	// Worker threads used by the parallel kernels. 0 (default) means one per core.
+	inline int& threadsSetting()      { static int n = 0; return n; }
+	inline void setNumThreads(int n)  { threadsSetting() = n; }
+	inline int  numThreads()
+	{
+		int n = threadsSetting();
+		if( n <= 0 ) n = (int)std::thread::hardware_concurrency();
+		return n > 0? n : 1;
+	}
+
+	// Number of threads worth using for a given amount of work
+	inline int numThreadsFor(long work, long minWork = ParallelMinWork)
+	{
+		long n = minWork > 0? work / minWork : work;
+		int  t = numThreads();
+		return n < 1? 1 : (n < t? (int)n : t);
+	}
+
+	// Run f(part, nParts) for part in [0,nParts), each on its own thread.
+	template<typename Lambda>
+	void parallelRun(int nParts, Lambda f)
+	{
+		if( nParts <= 1 )
+		{
+			f(0, 1);
+			return;
+		}
+		std::thread* th = new std::thread[nParts-1];
+		for (int p = 1; p < nParts; ++p)
+			th[p-1] = std::thread(f, p, nParts);
+		f(0, nParts);
+		for (int p = 1; p < nParts; ++p)
+			th[p-1].join();
+		delete [] th;
+	}
+
+	// Split [begin,end) into contiguous chunks of at least "grain" items, at most
+	// one per thread, and call f(b,e) on every chunk in parallel.
+	template<typename Lambda>
+	void parallelFor(int begin, int end, int grain, Lambda f)
+	{
+		if( end <= begin )
+			return;
+		int nParts = numThreadsFor(end-begin, grain);
+		parallelRun(nParts, [&](int p, int np)
+		{
+			long n = end - begin;
+			f(begin + (int)(n*p/np), begin + (int)(n*(p+1)/np));
+		});
+	}
+
+} // End of namespace DSA
+
+#endif
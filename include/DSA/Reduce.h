@@ -0,0 +1,148 @@
+// ================= DSA DLL Files =====================
+// File: Reduce.h
+// Reduction operators for Array2D<T>::reduceRows()/reduceCols() and ArrayND reduce().
+// =======================================================
+// Note:
+// A reduction operator provides:
+//     typedef ... Acc;                         // accumulator
+//     typedef ... Result;                      // reduced value
+//     Acc    init() const;                     // empty accumulator
+//     void   add(Acc& a, const T& v, int k);   // fold in v, the k-th element
+//     void   merge(Acc& a, const Acc& b);      // fold in a partial result (b after a)
+//     Result result(const Acc& a) const;
+// Min/Max (and their Arg versions) skip NaNs, as getMinMax() does; on ties the
+// first element wins. Empty reductions give T() (or -1 for an index).
+//
+
+#ifndef DSA_REDUCE_H
+#define DSA_REDUCE_H
+#include <DSA/DSA.h>
+#include <DSA/Simd.h>
+#include <cmath>
+
+namespace DSA
+{
+	// Running extreme and where it was found (k < 0: none yet)
+	template<typename T>
+	struct ValueAt
+	{
+		T    v;
+		int  k;
+	};
+
+	template<typename T>
+	struct ReduceSum
+	{
+		typedef T Acc;
+		typedef T Result;
+		inline Acc    init() const                         { return T(); }
+		inline void   add(Acc& a, const T& v, int) const   { a += v; }
+		inline void   merge(Acc& a, const Acc& b) const    { a += b; }
+		inline Result result(const Acc& a) const           { return a; }
+	};
+
+	template<typename T>
+	struct ReduceNorm1
+	{
+		typedef T Acc;
+		typedef T Result;
+		inline Acc    init() const                         { return T(); }
+		inline void   add(Acc& a, const T& v, int) const   { a += v < T()? -v : v; }
+		inline void   merge(Acc& a, const Acc& b) const    { a += b; }
+		inline Result result(const Acc& a) const           { return a; }
+	};
+
+	template<typename T>
+	struct ReduceNorm2
+	{
+		typedef T Acc;   // Sum of squares
+		typedef T Result;
+		inline Acc    init() const                         { return T(); }
+		inline void   add(Acc& a, const T& v, int) const   { a += v*v; }
+		inline void   merge(Acc& a, const Acc& b) const    { a += b; }
+		inline Result result(const Acc& a) const           { return (T)std::sqrt((double)a); }
+	};
+
+	template<typename T>
+	struct ReduceNormInf
+	{
+		typedef T Acc;
+		typedef T Result;
+		inline Acc    init() const                         { return T(); }
+		inline void   add(Acc& a, const T& v, int) const   { T m = v < T()? -v : v; if( a < m ) a = m; }
+		inline void   merge(Acc& a, const Acc& b) const    { if( a < b ) a = b; }
+		inline Result result(const Acc& a) const           { return a; }
+	};
+
+	template<typename T>
+	struct ReduceMean
+	{
+		typedef ValueAt<T> Acc;  // Sum and count
+		typedef T Result;
+		inline Acc    init() const                         { Acc a; a.v = T(); a.k = 0; return a; }
+		inline void   add(Acc& a, const T& v, int) const   { a.v += v; a.k++; }
+		inline void   merge(Acc& a, const Acc& b) const    { a.v += b.v; a.k += b.k; }
+		inline Result result(const Acc& a) const           { return a.k? (T)(a.v / a.k) : T(); }
+	};
+
+	// Shared accumulator logic of Min/Max/ArgMin/ArgMax
+	template<typename T, bool MAX>
+	struct ReduceExtreme
+	{
+		typedef ValueAt<T> Acc;
+		static inline bool beats(const T& x, const T& y)   { return MAX? y < x : x < y; }
+		inline Acc  init() const                           { Acc a; a.v = T(); a.k = -1; return a; }
+		inline void add(Acc& a, const T& v, int k) const
+		{
+			if( v == v && (a.k < 0 || beats(v, a.v)) ) { a.v = v; a.k = k; } // v == v: not NaN
+		}
+		inline void merge(Acc& a, const Acc& b) const
+		{
+			if( b.k >= 0 && (a.k < 0 || beats(b.v, a.v)) ) a = b;
+		}
+	};
+
+	template<typename T>
+	struct ReduceMin : public ReduceExtreme<T,false>
+	{
+		typedef T Result;
+		inline Result result(const ValueAt<T>& a) const    { return a.v; }
+	};
+
+	template<typename T>
+	struct ReduceMax : public ReduceExtreme<T,true>
+	{
+		typedef T Result;
+		inline Result result(const ValueAt<T>& a) const    { return a.v; }
+	};
+
+	template<typename T>
+	struct ReduceArgMin : public ReduceExtreme<T,false>
+	{
+		typedef int Result;
+		inline Result result(const ValueAt<T>& a) const    { return a.k; }
+	};
+
+	template<typename T>
+	struct ReduceArgMax : public ReduceExtreme<T,true>
+	{
+		typedef int Result;
+		inline Result result(const ValueAt<T>& a) const    { return a.k; }
+	};
+
+	// One row of a column reduction: add(acc[j], row[j], k) for j in [0,n)
+	template<typename T, class OP>
+	inline void addRow(const OP& op, typename OP::Acc* acc, const T* row, int n, int k)
+	{
+		for (int j = 0; j < n; ++j)
+			op.add(acc[j], row[j], k);
+	}
+	template<typename T>
+	inline void addRow(const ReduceSum<T>&, T* acc, const T* row, int n, int)
+	{
+		vadd(acc, row, n);
+	}
+
+} // End of namespace DSA
+
+#endif
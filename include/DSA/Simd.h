@@ -0,0 +1,328 @@
+// ================= DSA DLL Files =====================
+// File: Simd.h
+// Vector inner loops shared by the Array2D kernels (stencils, reductions).
+// =======================================================
+// Note:
+// Generic templates are plain loops; float and double are specialized with
+// SSE2 (always on x86-64), or AVX when compiled with -mavx.
+// Pointers must not overlap.
+// correlate() and combine() sum m weighted taps in one pass over y: the taps
+// of each group of (up to) SimdTaps sit in registers, and y is written once
+// per group instead of once per tap.
+//
+
+#ifndef DSA_SIMD_H
+#define DSA_SIMD_H
+#include <DSA/DSA.h>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace DSA
+{
+	// y[i] += a*x[i], i in [0,n)
+	template<typename T>
+	inline void axpy(T* y, const T* x, T a, int n)
+	{
+		for (int i = 0; i < n; ++i)
+			y[i] += a*x[i];
+	}
+
+	// y[i] += x[i], i in [0,n)
+	template<typename T>
+	inline void vadd(T* y, const T* x, int n)
+	{
+		for (int i = 0; i < n; ++i)
+			y[i] += x[i];
+	}
+
+#if defined(__AVX__)
+	template<>
+	inline void axpy<float>(float* y, const float* x, float a, int n)
+	{
+		int i = 0;
+		__m256 va = _mm256_set1_ps(a);
+		for (; i+8 <= n; i += 8)
+			_mm256_storeu_ps(y+i, _mm256_add_ps(_mm256_loadu_ps(y+i), _mm256_mul_ps(va, _mm256_loadu_ps(x+i))));
+		for (; i < n; ++i)
+			y[i] += a*x[i];
+	}
+	template<>
+	inline void axpy<double>(double* y, const double* x, double a, int n)
+	{
+		int i = 0;
+		__m256d va = _mm256_set1_pd(a);
+		for (; i+4 <= n; i += 4)
+			_mm256_storeu_pd(y+i, _mm256_add_pd(_mm256_loadu_pd(y+i), _mm256_mul_pd(va, _mm256_loadu_pd(x+i))));
+		for (; i < n; ++i)
+			y[i] += a*x[i];
+	}
+	template<>
+	inline void vadd<float>(float* y, const float* x, int n)
+	{
+		int i = 0;
+		for (; i+8 <= n; i += 8)
+			_mm256_storeu_ps(y+i, _mm256_add_ps(_mm256_loadu_ps(y+i), _mm256_loadu_ps(x+i)));
+		for (; i < n; ++i)
+			y[i] += x[i];
+	}
+	template<>
+	inline void vadd<double>(double* y, const double* x, int n)
+	{
+		int i = 0;
+		for (; i+4 <= n; i += 4)
+			_mm256_storeu_pd(y+i, _mm256_add_pd(_mm256_loadu_pd(y+i), _mm256_loadu_pd(x+i)));
+		for (; i < n; ++i)
+			y[i] += x[i];
+	}
+#elif defined(__SSE2__)
+	template<>
+	inline void axpy<float>(float* y, const float* x, float a, int n)
+	{
+		int i = 0;
+		__m128 va = _mm_set1_ps(a);
+		for (; i+4 <= n; i += 4)
+			_mm_storeu_ps(y+i, _mm_add_ps(_mm_loadu_ps(y+i), _mm_mul_ps(va, _mm_loadu_ps(x+i))));
+		for (; i < n; ++i)
+			y[i] += a*x[i];
+	}
+	template<>
+	inline void axpy<double>(double* y, const double* x, double a, int n)
+	{
+		int i = 0;
+		__m128d va = _mm_set1_pd(a);
+		for (; i+2 <= n; i += 2)
+			_mm_storeu_pd(y+i, _mm_add_pd(_mm_loadu_pd(y+i), _mm_mul_pd(va, _mm_loadu_pd(x+i))));
+		for (; i < n; ++i)
+			y[i] += a*x[i];
+	}
+	template<>
+	inline void vadd<float>(float* y, const float* x, int n)
+	{
+		int i = 0;
+		for (; i+4 <= n; i += 4)
+			_mm_storeu_ps(y+i, _mm_add_ps(_mm_loadu_ps(y+i), _mm_loadu_ps(x+i)));
+		for (; i < n; ++i)
+			y[i] += x[i];
+	}
+	template<>
+	inline void vadd<double>(double* y, const double* x, int n)
+	{
+		int i = 0;
+		for (; i+2 <= n; i += 2)
+			_mm_storeu_pd(y+i, _mm_add_pd(_mm_loadu_pd(y+i), _mm_loadu_pd(x+i)));
+		for (; i < n; ++i)
+			y[i] += x[i];
+	}
+#endif
+
+	// Taps kept in registers by one pass of correlate()/combine()
+	enum { SimdTaps = 8 };
+
+	// y[i] = sum w[b]*x[i+b], b in [0,m), i in [0,n)
+	template<typename T>
+	inline void correlate(T* y, const T* x, const T* w, int m, int n)
+	{
+		for (int i = 0; i < n; ++i)
+		{
+			T s = T();
+			for (int b = 0; b < m; ++b)
+				s += w[b]*x[i+b];
+			y[i] = s;
+		}
+	}
+
+	// y[i] = sum w[a]*x[a][i], a in [0,m), i in [0,n)
+	template<typename T>
+	inline void combine(T* y, const T* const* x, const T* w, int m, int n)
+	{
+		for (int i = 0; i < n; ++i)
+		{
+			T s = T();
+			for (int a = 0; a < m; ++a)
+				s += w[a]*x[a][i];
+			y[i] = s;
+		}
+	}
+
+#if defined(__AVX__) || defined(__SSE2__)
+	// Vector of float or double, for the tap kernels below
+	template<typename T> struct SimdVec;
+#if defined(__AVX__)
+	template<> struct SimdVec<float>
+	{
+		typedef __m256 V;
+		enum { N = 8 };
+		static V    set1(float a)            { return _mm256_set1_ps(a); }
+		static V    zero()                   { return _mm256_setzero_ps(); }
+		static V    load(const float* p)     { return _mm256_loadu_ps(p); }
+		static void store(float* p, V v)     { _mm256_storeu_ps(p, v); }
+		static V    madd(V s, V a, V x)      { return _mm256_add_ps(s, _mm256_mul_ps(a, x)); }
+	};
+	template<> struct SimdVec<double>
+	{
+		typedef __m256d V;
+		enum { N = 4 };
+		static V    set1(double a)           { return _mm256_set1_pd(a); }
+		static V    zero()                   { return _mm256_setzero_pd(); }
+		static V    load(const double* p)    { return _mm256_loadu_pd(p); }
+		static void store(double* p, V v)    { _mm256_storeu_pd(p, v); }
+		static V    madd(V s, V a, V x)      { return _mm256_add_pd(s, _mm256_mul_pd(a, x)); }
+	};
+#else
+	template<> struct SimdVec<float>
+	{
+		typedef __m128 V;
+		enum { N = 4 };
+		static V    set1(float a)            { return _mm_set1_ps(a); }
+		static V    zero()                   { return _mm_setzero_ps(); }
+		static V    load(const float* p)     { return _mm_loadu_ps(p); }
+		static void store(float* p, V v)     { _mm_storeu_ps(p, v); }
+		static V    madd(V s, V a, V x)      { return _mm_add_ps(s, _mm_mul_ps(a, x)); }
+	};
+	template<> struct SimdVec<double>
+	{
+		typedef __m128d V;
+		enum { N = 2 };
+		static V    set1(double a)           { return _mm_set1_pd(a); }
+		static V    zero()                   { return _mm_setzero_pd(); }
+		static V    load(const double* p)    { return _mm_loadu_pd(p); }
+		static void store(double* p, V v)    { _mm_storeu_pd(p, v); }
+		static V    madd(V s, V a, V x)      { return _mm_add_pd(s, _mm_mul_pd(a, x)); }
+	};
+#endif
+
+	// s + the M taps at one vector position, unrolled at compile time
+	template<typename T, int M> struct SimdTapSum
+	{
+		typedef typename SimdVec<T>::V V;
+		// Shifted loads: x[0], x[1], ...
+		static V shifted(V s, const V* w, const T* x)
+		{ return SimdTapSum<T,M-1>::shifted(SimdVec<T>::madd(s, w[0], SimdVec<T>::load(x)), w+1, x+1); }
+		// One load per row: x[0]+i, x[1]+i, ...
+		static V rows(V s, const V* w, const T* const* x, int i)
+		{ return SimdTapSum<T,M-1>::rows(SimdVec<T>::madd(s, w[0], SimdVec<T>::load(x[0]+i)), w+1, x+1, i); }
+	};
+	template<typename T> struct SimdTapSum<T,0>
+	{
+		typedef typename SimdVec<T>::V V;
+		static V shifted(V s, const V*, const T*)             { return s; }
+		static V rows(V s, const V*, const T* const*, int)    { return s; }
+	};
+
+	// M taps (a compile-time count, so the taps stay in registers);
+	// "add": accumulate into y rather than overwrite it
+	template<typename T, int M>
+	inline void correlateTaps(T* y, const T* x, const T* w, int n, bool add)
+	{
+		typedef SimdVec<T> S;
+		typename S::V vw[M];
+		for (int b = 0; b < M; ++b)
+			vw[b] = S::set1(w[b]);
+		int i = 0;
+		for (; i+S::N <= n; i += S::N)
+		{
+			typename S::V s = add? S::load(y+i) : S::zero();
+			S::store(y+i, SimdTapSum<T,M>::shifted(s, vw, x+i));
+		}
+		for (; i < n; ++i)
+		{
+			T s = add? y[i] : T();
+			for (int b = 0; b < M; ++b)
+				s += w[b]*x[i+b];
+			y[i] = s;
+		}
+	}
+	template<typename T, int M>
+	inline void combineTaps(T* y, const T* const* x, const T* w, int n, bool add)
+	{
+		typedef SimdVec<T> S;
+		typename S::V vw[M];
+		const T* xa[M];
+		for (int a = 0; a < M; ++a)
+		{
+			vw[a] = S::set1(w[a]);
+			xa[a] = x[a];
+		}
+		int i = 0;
+		for (; i+S::N <= n; i += S::N)
+		{
+			typename S::V s = add? S::load(y+i) : S::zero();
+			S::store(y+i, SimdTapSum<T,M>::rows(s, vw, xa, i));
+		}
+		for (; i < n; ++i)
+		{
+			T s = add? y[i] : T();
+			for (int a = 0; a < M; ++a)
+				s += w[a]*xa[a][i];
+			y[i] = s;
+		}
+	}
+
+	// Groups of SimdTaps taps, the first one overwriting y
+	template<typename T>
+	inline void correlateSimd(T* y, const T* x, const T* w, int m, int n)
+	{
+		if( m <= 0 )
+		{
+			for (int i = 0; i < n; ++i) y[i] = T();
+			return;
+		}
+		for (int b = 0; b < m; b += SimdTaps)
+		{
+			bool add = b > 0;
+			switch( m-b < SimdTaps? m-b : (int)SimdTaps )
+			{
+			case 1:  correlateTaps<T,1>(y, x+b, w+b, n, add); break;
+			case 2:  correlateTaps<T,2>(y, x+b, w+b, n, add); break;
+			case 3:  correlateTaps<T,3>(y, x+b, w+b, n, add); break;
+			case 4:  correlateTaps<T,4>(y, x+b, w+b, n, add); break;
+			case 5:  correlateTaps<T,5>(y, x+b, w+b, n, add); break;
+			case 6:  correlateTaps<T,6>(y, x+b, w+b, n, add); break;
+			case 7:  correlateTaps<T,7>(y, x+b, w+b, n, add); break;
+			default: correlateTaps<T,8>(y, x+b, w+b, n, add); break;
+			}
+		}
+	}
+	template<typename T>
+	inline void combineSimd(T* y, const T* const* x, const T* w, int m, int n)
+	{
+		if( m <= 0 )
+		{
+			for (int i = 0; i < n; ++i) y[i] = T();
+			return;
+		}
+		for (int a = 0; a < m; a += SimdTaps)
+		{
+			bool add = a > 0;
+			switch( m-a < SimdTaps? m-a : (int)SimdTaps )
+			{
+			case 1:  combineTaps<T,1>(y, x+a, w+a, n, add); break;
+			case 2:  combineTaps<T,2>(y, x+a, w+a, n, add); break;
+			case 3:  combineTaps<T,3>(y, x+a, w+a, n, add); break;
+			case 4:  combineTaps<T,4>(y, x+a, w+a, n, add); break;
+			case 5:  combineTaps<T,5>(y, x+a, w+a, n, add); break;
+			case 6:  combineTaps<T,6>(y, x+a, w+a, n, add); break;
+			case 7:  combineTaps<T,7>(y, x+a, w+a, n, add); break;
+			default: combineTaps<T,8>(y, x+a, w+a, n, add); break;
+			}
+		}
+	}
+
+	template<>
+	inline void correlate<float>(float* y, const float* x, const float* w, int m, int n)
+	{ correlateSimd(y, x, w, m, n); }
+	template<>
+	inline void correlate<double>(double* y, const double* x, const double* w, int m, int n)
+	{ correlateSimd(y, x, w, m, n); }
+	template<>
+	inline void combine<float>(float* y, const float* const* x, const float* w, int m, int n)
+	{ combineSimd(y, x, w, m, n); }
+	template<>
+	inline void combine<double>(double* y, const double* const* x, const double* w, int m, int n)
+	{ combineSimd(y, x, w, m, n); }
+#endif
+
+} // End of namespace DSA
+
+#endif
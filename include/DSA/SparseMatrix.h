@@ -0,0 +1,170 @@
+// ================= DSA DLL Files =====================
+// File: SparseMatrix.h
+// Compressed sparse row/column matrices (CSR, CSC) interoperating with
+// Array<T> and Array2D<T>.
+// =======================================================
+// Note:
+// CSR stores the non-zeros of row i at [ptr[i], ptr[i+1]) of idx (column) and
+// val, with columns ascending. CSC is the same along columns. Memory is
+// (nnz*(sizeof(T)+4) + 4*(n+1)) bytes, instead of rows*cols*sizeof(T).
+//
+
+#ifndef DSA_SPARSEMATRIX_H
+#define DSA_SPARSEMATRIX_H
+#include <DSA/DSA.h>
+#include <DSA/Array.h>
+#include <DSA/Array2D.h>
+#include <DSA/Parallel.h>
+
+namespace DSA
+{
+	template<typename T> class CSRMatrix;
+	template<typename T> class CSCMatrix;
+
+	// Compressed storage along a "major" dimension (rows for CSR, columns for CSC)
+	template<typename T>
+	class Compressed
+	{
+	protected: // Data Members
+		int         m_major;  // Number of rows (CSR) or columns (CSC)
+		int         m_minor;  // Number of columns (CSR) or rows (CSC)
+		Array<int>  m_ptr;    // Entries of major #k are [m_ptr[k], m_ptr[k+1])
+		Array<int>  m_idx;    // Minor index of each entry, ascending within a major
+		Array<T>    m_val;    // Value of each entry
+
+	public:
+		Compressed() : m_major(0), m_minor(0) { m_ptr.alloc(1); m_ptr[0] = 0; }
+		virtual ~Compressed() {}
+
+		// Number of stored (non-zero) entries
+		inline int nnz() const { return m_ptr[m_major]; }
+
+		// Raw compressed arrays
+		inline const int* ptr() const { return m_ptr.begin(); }
+		inline const int* idx() const { return m_idx.begin(); }
+		inline const T*   val() const { return m_val.begin(); }
+		inline T*         val()       { return m_val.begin(); }
+
+		// Stored value at (major, minor), 0 if not stored. Binary search.
+		T at(int major, int minor) const;
+
+	protected:
+		// Build from n (major, minor, value) triplets in O(n + major + minor):
+		// bucket by minor, then stably by major, so minors come out sorted.
+		// Duplicated (major, minor) entries are summed.
+		bool compress(int nMajor, int nMinor, const int* major, const int* minor, const T* v, int n);
+		// Build as the transpose of another compressed storage
+		bool transpose(const Compressed<T>& src);
+		// Reset to an empty (nMajor x nMinor) matrix
+		void clear(int nMajor, int nMinor);
+	};
+
+
+	// A non-owning view on the rows [r0, r0+rows) of a CSR matrix
+	template<typename T>
+	struct CSRView
+	{
+		int        r0;    // First row (in the viewed matrix)
+		int        rows;  // Number of rows
+		int        cols;  // Number of columns
+		const int* ptr;   // rows+1 offsets into idx/val (NOT rebased to 0)
+		const int* idx;
+		const T*   val;
+
+		inline int nnz() const { return ptr[rows]-ptr[0]; }
+
+		// Sub-view of rows [i0, i1) of this view
+		CSRView<T> slice(int i0, int i1) const;
+
+		// y = A x. Rows are split among threads with equal shares of non-zeros.
+		bool multiply(const Array<T>& x, Array<T>& y) const;
+		// Y = A X  (X is cols x k, Y is rows x k)
+		bool multiply(const Array2D<T>& x, Array2D<T>& y) const;
+
+		// Row range [i0, i1) of part p (of np) holding about nnz()/np entries
+		void part(int p, int np, int& i0, int& i1) const;
+	};
+
+
+	// Compressed Sparse Row matrix
+	template<typename T>
+	class CSRMatrix : public Compressed<T>
+	{
+		using Compressed<T>::m_major;
+		using Compressed<T>::m_minor;
+		using Compressed<T>::m_ptr;
+		using Compressed<T>::m_idx;
+		using Compressed<T>::m_val;
+	public:
+		CSRMatrix() {}
+		CSRMatrix(int nRow, int nCol) { this->clear(nRow, nCol); }
+		virtual ~CSRMatrix() {}
+
+		// Build from n triplets (i[k], j[k], v[k]); duplicates are summed.
+		bool build(int nRow, int nCol, const int* i, const int* j, const T* v, int n)
+		{ return this->compress(nRow, nCol, i, j, v, n); }
+		// Build from the non-zero elements of a dense array
+		bool build(const Array2D<T>& a);
+		// Build from a CSC matrix
+		bool build(const CSCMatrix<T>& a) { return this->transpose(a); }
+
+		// Convert back to a dense array
+		bool toDense(Array2D<T>& a) const;
+
+		inline int rows() const { return m_major; }
+		inline int cols() const { return m_minor; }
+		// Element (i,j), 0 if not stored
+		inline T   operator()(int i, int j) const { return this->at(i, j); }
+
+		// Whole matrix, or rows [r0, r1), as a view
+		CSRView<T> view() const                 { return slice(0, m_major); }
+		CSRView<T> slice(int r0, int r1) const;
+
+		// y = A x,  Y = A X  (multi-threaded over rows)
+		bool multiply(const Array<T>& x, Array<T>& y) const     { return view().multiply(x, y); }
+		bool multiply(const Array2D<T>& x, Array2D<T>& y) const { return view().multiply(x, y); }
+	};
+
+
+	// Compressed Sparse Column matrix
+	template<typename T>
+	class CSCMatrix : public Compressed<T>
+	{
+		using Compressed<T>::m_major;
+		using Compressed<T>::m_minor;
+		using Compressed<T>::m_ptr;
+		using Compressed<T>::m_idx;
+		using Compressed<T>::m_val;
+	public:
+		CSCMatrix() {}
+		CSCMatrix(int nRow, int nCol) { this->clear(nCol, nRow); }
+		virtual ~CSCMatrix() {}
+
+		// Build from n triplets (i[k], j[k], v[k]); duplicates are summed.
+		bool build(int nRow, int nCol, const int* i, const int* j, const T* v, int n)
+		{ return this->compress(nCol, nRow, j, i, v, n); }
+		// Build from the non-zero elements of a dense array
+		bool build(const Array2D<T>& a);
+		// Build from a CSR matrix
+		bool build(const CSRMatrix<T>& a) { return this->transpose(a); }
+
+		// Convert back to a dense array
+		bool toDense(Array2D<T>& a) const;
+
+		inline int rows() const { return m_minor; }
+		inline int cols() const { return m_major; }
+		// Element (i,j), 0 if not stored
+		inline T   operator()(int i, int j) const { return this->at(j, i); }
+
+		// y = A x. Columns are split among threads, each scattering into its own
+		// partial y, which are then summed.
+		bool multiply(const Array<T>& x, Array<T>& y) const;
+		// Y = A X. Threads own disjoint column ranges of X and Y: no partial sums.
+		bool multiply(const Array2D<T>& x, Array2D<T>& y) const;
+	};
+
+} // End of namespace DSA
+
+#include <DSA/SparseMatrix.inl>
+
+#endif
@@ -0,0 +1,376 @@
+// ================= DSA DLL Files =====================
+// File: SparseMatrix.inl
+// =======================================================
+// Note:
+//
+#ifndef DSA_SPARSEMATRIX_INL
+#define DSA_SPARSEMATRIX_INL
+//	Prerequisites:
+#include <algorithm> // std::lower_bound
+
+/*==========================================================================*\
+**				Non-inline template function definitions					**
+\*==========================================================================*/
+
+namespace DSA
+{
+	//
+	//	Compressed<T>
+	//
+	template<typename T>
+	void Compressed<T>::clear(int nMajor, int nMinor)
+	{
+		m_major = nMajor < 0? 0 : nMajor;
+		m_minor = nMinor < 0? 0 : nMinor;
+		m_ptr.alloc(m_major+1);
+		m_ptr = 0;
+		m_idx.resize(0);
+		m_val.resize(0);
+	}
+
+	template<typename T>
+	bool Compressed<T>::compress(int nMajor, int nMinor, const int* major, const int* minor, const T* v, int n)
+	{
+		clear(nMajor, nMinor);
+		for (int k = 0; k < n; ++k)
+			if( major[k] < 0 || major[k] >= m_major || minor[k] < 0 || minor[k] >= m_minor )
+				return false;
+		if( n <= 0 )
+			return true;
+
+		// Pass 1: counting sort by minor
+		Array<int> cnt(m_minor+1);
+		Array<int> order(n);
+		cnt = 0;
+		for (int k = 0; k < n; ++k) cnt[minor[k]+1]++;
+		for (int j = 0; j < m_minor; ++j) cnt[j+1] += cnt[j];
+		for (int k = 0; k < n; ++k) order[cnt[minor[k]]++] = k;
+
+		// Pass 2: stable counting sort by major
+		for (int k = 0; k < n; ++k) m_ptr[major[k]+1]++;
+		for (int i = 0; i < m_major; ++i) m_ptr[i+1] += m_ptr[i];
+		Array<int> pos(m_ptr.begin(), m_major);
+		if( ! m_idx.alloc(n) || ! m_val.alloc(n) )
+			return false;
+		for (int t = 0; t < n; ++t)
+		{
+			int k = order[t];
+			int p = pos[major[k]]++;
+			m_idx[p] = minor[k];
+			m_val[p] = v[k];
+		}
+
+		// Sum duplicates, compacting in place
+		int w = 0;
+		for (int i = 0; i < m_major; ++i)
+		{
+			int start = m_ptr[i], end = m_ptr[i+1];
+			m_ptr[i] = w;
+			for (int p = start; p < end; ++p)
+			{
+				if( w > m_ptr[i] && m_idx[w-1] == m_idx[p] )
+					m_val[w-1] += m_val[p];
+				else
+				{
+					m_idx[w] = m_idx[p];
+					m_val[w] = m_val[p];
+					w++;
+				}
+			}
+		}
+		m_ptr[m_major] = w;
+		m_idx.resize(w);
+		m_val.resize(w);
+		return true;
+	}
+
+	template<typename T>
+	bool Compressed<T>::transpose(const Compressed<T>& src)
+	{
+		clear(src.m_minor, src.m_major);
+		int n = src.nnz();
+		if( ! m_idx.alloc(n) || ! m_val.alloc(n) )
+			return false;
+		for (int p = 0; p < n; ++p) m_ptr[src.m_idx[p]+1]++;
+		for (int i = 0; i < m_major; ++i) m_ptr[i+1] += m_ptr[i];
+
+		// Walking the source majors in order keeps the new minors ascending
+		Array<int> pos(m_ptr.begin(), m_major);
+		for (int j = 0; j < src.m_major; ++j)
+			for (int p = src.m_ptr[j]; p < src.m_ptr[j+1]; ++p)
+			{
+				int q = pos[src.m_idx[p]]++;
+				m_idx[q] = j;
+				m_val[q] = src.m_val[p];
+			}
+		return true;
+	}
+
+	template<typename T>
+	T Compressed<T>::at(int major, int minor) const
+	{
+		const int* b = m_idx.begin() + m_ptr[major];
+		const int* e = m_idx.begin() + m_ptr[major+1];
+		const int* f = std::lower_bound(b, e, minor);
+		return (f != e && *f == minor)? m_val[(int)(f - m_idx.begin())] : T();
+	}
+
+
+	//
+	//	CSRView<T>
+	//
+	template<typename T>
+	CSRView<T> CSRView<T>::slice(int i0, int i1) const
+	{
+		CSRView<T> v(*this);
+		if( i0 < 0 )    i0 = 0;
+		if( i1 > rows ) i1 = rows;
+		if( i1 < i0 )   i1 = i0;
+		v.r0   = r0 + i0;
+		v.rows = i1 - i0;
+		v.ptr  = ptr + i0;
+		return v;
+	}
+
+	template<typename T>
+	void CSRView<T>::part(int p, int np, int& i0, int& i1) const
+	{
+		long total = nnz();
+		int  t0 = ptr[0] + (int)(total*p/np);
+		int  t1 = ptr[0] + (int)(total*(p+1)/np);
+		i0 = p == 0?    0    : (int)(std::lower_bound(ptr, ptr+rows+1, t0) - ptr);
+		i1 = p == np-1? rows : (int)(std::lower_bound(ptr, ptr+rows+1, t1) - ptr);
+		if( i0 > rows ) i0 = rows;
+		if( i1 > rows ) i1 = rows;
+	}
+
+	template<typename T>
+	bool CSRView<T>::multiply(const Array<T>& x, Array<T>& y) const
+	{
+		if( x.len() != cols || ! y.alloc(rows) )
+			return false;
+		const T* xp = x.begin();
+		T*       yp = y.begin();
+		parallelRun(numThreadsFor(nnz()), [&](int p, int np)
+		{
+			int i0, i1;
+			part(p, np, i0, i1);
+			for (int i = i0; i < i1; ++i)
+			{
+				T sum = T();
+				for (int k = ptr[i]; k < ptr[i+1]; ++k)
+					sum += val[k] * xp[idx[k]];
+				yp[i] = sum;
+			}
+		});
+		return true;
+	}
+
+	template<typename T>
+	bool CSRView<T>::multiply(const Array2D<T>& x, Array2D<T>& y) const
+	{
+		int nc = x.cols();
+		if( x.rows() != cols || ! y.alloc(rows, nc) )
+			return false;
+		parallelRun(numThreadsFor((long)nnz()*nc), [&](int p, int np)
+		{
+			int i0, i1;
+			part(p, np, i0, i1);
+			for (int i = i0; i < i1; ++i)
+			{
+				T* yr = y[i];
+				for (int c = 0; c < nc; ++c) yr[c] = T();
+				for (int k = ptr[i]; k < ptr[i+1]; ++k)
+				{
+					const T  a  = val[k];
+					const T* xr = x[idx[k]];
+					for (int c = 0; c < nc; ++c)
+						yr[c] += a * xr[c];
+				}
+			}
+		});
+		return true;
+	}
+
+
+	//
+	//	CSRMatrix<T>
+	//
+	template<typename T>
+	bool CSRMatrix<T>::build(const Array2D<T>& a)
+	{
+		this->clear(a.rows(), a.cols());
+		for (int i = 0; i < a.rows(); ++i)
+		{
+			const T* row = a[i];
+			int cnt = 0;
+			for (int j = 0; j < a.cols(); ++j)
+				if( row[j] != T() ) cnt++;
+			m_ptr[i+1] = m_ptr[i] + cnt;
+		}
+		if( ! m_idx.alloc(this->nnz()) || ! m_val.alloc(this->nnz()) )
+			return false;
+		int w = 0;
+		for (int i = 0; i < a.rows(); ++i)
+		{
+			const T* row = a[i];
+			for (int j = 0; j < a.cols(); ++j)
+				if( row[j] != T() )
+				{
+					m_idx[w] = j;
+					m_val[w] = row[j];
+					w++;
+				}
+		}
+		return true;
+	}
+
+	template<typename T>
+	bool CSRMatrix<T>::toDense(Array2D<T>& a) const
+	{
+		if( ! a.alloc(m_major, m_minor) )
+			return false;
+		a = T();
+		for (int i = 0; i < m_major; ++i)
+		{
+			T* row = a[i];
+			for (int k = m_ptr[i]; k < m_ptr[i+1]; ++k)
+				row[m_idx[k]] = m_val[k];
+		}
+		return true;
+	}
+
+	template<typename T>
+	CSRView<T> CSRMatrix<T>::slice(int r0, int r1) const
+	{
+		CSRView<T> v;
+		v.r0   = 0;
+		v.rows = m_major;
+		v.cols = m_minor;
+		v.ptr  = m_ptr.begin();
+		v.idx  = m_idx.begin();
+		v.val  = m_val.begin();
+		return v.slice(r0, r1);
+	}
+
+
+	//
+	//	CSCMatrix<T>
+	//
+	template<typename T>
+	bool CSCMatrix<T>::build(const Array2D<T>& a)
+	{
+		this->clear(a.cols(), a.rows());
+		for (int i = 0; i < a.rows(); ++i)
+		{
+			const T* row = a[i];
+			for (int j = 0; j < a.cols(); ++j)
+				if( row[j] != T() ) m_ptr[j+1]++;
+		}
+		for (int j = 0; j < m_major; ++j) m_ptr[j+1] += m_ptr[j];
+		if( ! m_idx.alloc(this->nnz()) || ! m_val.alloc(this->nnz()) )
+			return false;
+
+		// Row-major walk: row indices come out ascending in every column
+		Array<int> pos(m_ptr.begin(), m_major);
+		for (int i = 0; i < a.rows(); ++i)
+		{
+			const T* row = a[i];
+			for (int j = 0; j < a.cols(); ++j)
+				if( row[j] != T() )
+				{
+					int q = pos[j]++;
+					m_idx[q] = i;
+					m_val[q] = row[j];
+				}
+		}
+		return true;
+	}
+
+	template<typename T>
+	bool CSCMatrix<T>::toDense(Array2D<T>& a) const
+	{
+		if( ! a.alloc(m_minor, m_major) )
+			return false;
+		a = T();
+		for (int j = 0; j < m_major; ++j)
+			for (int k = m_ptr[j]; k < m_ptr[j+1]; ++k)
+				a[m_idx[k]][j] = m_val[k];
+		return true;
+	}
+
+	template<typename T>
+	bool CSCMatrix<T>::multiply(const Array<T>& x, Array<T>& y) const
+	{
+		if( x.len() != m_major || ! y.alloc(m_minor) )
+			return false;
+		const int nRow = m_minor;
+		const int np   = numThreadsFor(this->nnz());
+		Array<T>  partial(np > 1? (np-1)*nRow : 0); // y of parts 1..np-1
+		const T*  xp = x.begin();
+
+		// A column view of the same storage splits the columns by non-zeros
+		CSRView<T> byCol;
+		byCol.r0 = 0; byCol.rows = m_major; byCol.cols = m_minor;
+		byCol.ptr = m_ptr.begin(); byCol.idx = m_idx.begin(); byCol.val = m_val.begin();
+
+		parallelRun(np, [&](int p, int n)
+		{
+			T* yp = p == 0? y.begin() : partial.begin() + (p-1)*nRow;
+			for (int i = 0; i < nRow; ++i) yp[i] = T();
+			int j0, j1;
+			byCol.part(p, n, j0, j1);
+			for (int j = j0; j < j1; ++j)
+			{
+				const T a = xp[j];
+				for (int k = m_ptr[j]; k < m_ptr[j+1]; ++k)
+					yp[m_idx[k]] += m_val[k] * a;
+			}
+		});
+
+		// Sum the partial results into y
+		if( np > 1 )
+		{
+			T* yp = y.begin();
+			parallelFor(0, nRow, ParallelMinWork, [&](int i0, int i1)
+			{
+				for (int p = 1; p < np; ++p)
+				{
+					const T* pp = partial.begin() + (p-1)*nRow;
+					for (int i = i0; i < i1; ++i)
+						yp[i] += pp[i];
+				}
+			});
+		}
+		return true;
+	}
+
+	template<typename T>
+	bool CSCMatrix<T>::multiply(const Array2D<T>& x, Array2D<T>& y) const
+	{
+		const int nc = x.cols();
+		if( x.rows() != m_major || ! y.alloc(m_minor, nc) )
+			return false;
+		y = T();
+		int np = numThreadsFor((long)this->nnz()*nc);
+		if( np > nc ) np = nc;
+		parallelRun(np, [&](int p, int n)
+		{
+			int c0 = nc*p/n, c1 = nc*(p+1)/n;
+			for (int j = 0; j < m_major; ++j)
+			{
+				const T* xr = x[j];
+				for (int k = m_ptr[j]; k < m_ptr[j+1]; ++k)
+				{
+					const T a  = m_val[k];
+					T*      yr = y[m_idx[k]];
+					for (int c = c0; c < c1; ++c)
+						yr[c] += a * xr[c];
+				}
+			}
+		});
+		return true;
+	}
+
+}// End of namespace DSA
+#endif
@@ -0,0 +1,85 @@
+// ================= DSA DLL Files =====================
+// File: Stencil.h
+// 2-D stencils (filters, convolutions) over Array2D<T>.
+// =======================================================
+// Note:
+// dst(i,j) = sum w(a,b) * src(i+a-ry, j+b-rx), with (ry,rx) the kernel center
+// (kh/2, kw/2). This is a correlation: flip the kernel for a true convolution.
+// Rows are split into bands, one per thread. Every source row is extended once
+// by the border policy into a small ring of rows; the inner loops are then
+// contiguous axpy()s (see Simd.h). A separable kernel filters each source row
+// once into the ring, then sums the ring rows into the output row, each in one
+// pass with the taps in registers (correlate() and combine()).
+//
+
+#ifndef DSA_STENCIL_H
+#define DSA_STENCIL_H
+#include <DSA/DSA.h>
+#include <DSA/Array.h>
+#include <DSA/Array2D.h>
+#include <DSA/Parallel.h>
+#include <DSA/Simd.h>
+
+namespace DSA
+{
+	template<typename T>
+	class Stencil
+	{
+	public:
+		// How elements outside the source are read
+		enum Border
+		{
+			Clamp, // Nearest edge element
+			Zero,  // T()
+			Wrap   // Periodic
+		};
+
+		Stencil() : m_separable(false), m_border(Clamp) {}
+		virtual ~Stencil() {}
+
+		// General kernel: w(a,b) = kernel[a][b]
+		bool set(const Array2D<T>& kernel, Border border = Clamp);
+		// Separable kernel: w(a,b) = ky[a]*kx[b]
+		bool set(const T* kx, int nx, const T* ky, int ny, Border border = Clamp);
+
+		// Filter src into dst (resized to match). src and dst may be the same array.
+		bool apply(const Array2D<T>& src, Array2D<T>& dst) const;
+
+		inline bool   isSeparable() const { return m_separable; }
+		inline Border border() const      { return m_border; }
+		inline int    height() const      { return m_separable? m_ky.len() : m_k.rows(); }
+		inline int    width() const       { return m_separable? m_kx.len() : m_k.cols(); }
+
+	protected:
+		Array2D<T>  m_k;          // General weights
+		Array<T>    m_kx, m_ky;   // Separable weights
+		bool        m_separable;
+		Border      m_border;
+
+		// Filter output rows [i0,i1)
+		void bandGeneral(const Array2D<T>& src, Array2D<T>& dst, int i0, int i1) const;
+		void bandSeparable(const Array2D<T>& src, Array2D<T>& dst, int i0, int i1) const;
+
+		// Index q in [0,n) by the border policy, -1 for a Zero border
+		inline int map(int q, int n) const
+		{
+			if( q >= 0 && q < n ) return q;
+			switch( m_border )
+			{
+			case Clamp: return q < 0? 0 : n-1;
+			case Wrap:  return ((q % n) + n) % n;
+			default:    return -1;
+			}
+		}
+		// Filter a row of n by the separable weights kx into h; ext: scratch of
+		// n+nx-1 (n < nx) or 2*nx elements
+		void filterRow(const T* row, int n, T* h, T* ext) const;
+		// Copy a row of n into ext, with "left" and "right" border elements around it
+		void extend(const T* row, int n, int left, int right, T* ext) const;
+	};
+
+} // End of namespace DSA
+
+#include <DSA/Stencil.inl>
+
+#endif
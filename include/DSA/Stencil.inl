@@ -0,0 +1,195 @@
+// ================= DSA DLL Files =====================
+// File: Stencil.inl
+// =======================================================
+// Note:
+//
+#ifndef DSA_STENCIL_INL
+#define DSA_STENCIL_INL
+//	Prerequisites:
+#include <climits>
+
+/*==========================================================================*\
+**				Non-inline template function definitions					**
+\*==========================================================================*/
+
+namespace DSA
+{
+	template<typename T>
+	bool Stencil<T>::set(const Array2D<T>& kernel, Border border)
+	{
+		if( kernel.rows() <= 0 || kernel.cols() <= 0 )
+			return false;
+		m_k = kernel;
+		m_kx.resize(0);
+		m_ky.resize(0);
+		m_separable = false;
+		m_border = border;
+		return true;
+	}
+
+	template<typename T>
+	bool Stencil<T>::set(const T* kx, int nx, const T* ky, int ny, Border border)
+	{
+		if( nx <= 0 || ny <= 0 )
+			return false;
+		m_kx.copy(kx, nx, nx);
+		m_ky.copy(ky, ny, ny);
+		m_k.alloc(0, 0);
+		m_separable = true;
+		m_border = border;
+		return true;
+	}
+
+	template<typename T>
+	bool Stencil<T>::apply(const Array2D<T>& src, Array2D<T>& dst) const
+	{
+		if( &src == &dst )
+		{
+			Array2D<T> tmp;
+			if( ! apply(src, tmp) )
+				return false;
+			dst = tmp;
+			return true;
+		}
+		if( height() <= 0 || ! dst.alloc(src.rows(), src.cols()) )
+			return false;
+		if( src.rows() == 0 || src.cols() == 0 )
+			return true;
+
+		// Bands of at least ParallelMinWork multiply-adds
+		long work  = (long)src.cols() * (m_separable? width()+height() : width()*height());
+		int  grain = (int)(ParallelMinWork / work) + 1;
+		parallelFor(0, src.rows(), grain, [&](int i0, int i1)
+		{
+			if( m_separable )
+				bandSeparable(src, dst, i0, i1);
+			else
+				bandGeneral(src, dst, i0, i1);
+		});
+		return true;
+	}
+
+	template<typename T>
+	void Stencil<T>::bandGeneral(const Array2D<T>& src, Array2D<T>& dst, int i0, int i1) const
+	{
+		const int rows = src.rows(), cols = src.cols();
+		const int kh = m_k.rows(), kw = m_k.cols();
+		const int ry = kh/2, rx = kw/2;
+
+		// Ring of extended source rows: source row q lives in slot q mod kh
+		Array2D<T> ring(kh, cols+kw-1);
+		Array<int> slot(kh);
+		slot = INT_MIN;
+
+		for (int i = i0; i < i1; ++i)
+		{
+			T* out = dst[i];
+			for (int j = 0; j < cols; ++j) out[j] = T();
+			for (int a = 0; a < kh; ++a)
+			{
+				int q = i + a - ry;
+				int r = map(q, rows);
+				if( r < 0 )
+					continue;
+				int s = ((q % kh) + kh) % kh;
+				if( slot[s] != q )
+				{
+					extend(src[r], cols, rx, kw-1-rx, ring[s]);
+					slot[s] = q;
+				}
+				const T* ext = ring[s];
+				const T* w   = m_k[a];
+				for (int b = 0; b < kw; ++b)
+					axpy(out, ext+b, w[b], cols);
+			}
+		}
+	}
+
+	template<typename T>
+	void Stencil<T>::bandSeparable(const Array2D<T>& src, Array2D<T>& dst, int i0, int i1) const
+	{
+		const int rows = src.rows(), cols = src.cols();
+		const int nx = m_kx.len(), ny = m_ky.len();
+		const int ry = ny/2;
+
+		// Ring of horizontally filtered rows: source row q lives in slot q mod ny,
+		// filtered once when it enters the ring
+		Array<T>   ext(cols < nx? cols+nx-1 : 2*nx);
+		Array2D<T> ring(ny, cols);
+		Array<int> slot(ny);
+		slot = INT_MIN;
+		// Rows and weights of the vertical taps of one output row
+		Array<const T*> h(ny);
+		Array<T>        wy(ny);
+
+		for (int i = i0; i < i1; ++i)
+		{
+			int m = 0;
+			for (int a = 0; a < ny; ++a)
+			{
+				int q = i + a - ry;
+				int r = map(q, rows);
+				if( r < 0 )
+					continue;
+				int s = ((q % ny) + ny) % ny;
+				if( slot[s] != q )
+				{
+					filterRow(src[r], cols, ring[s], ext.begin());
+					slot[s] = q;
+				}
+				h[m]  = ring[s];
+				wy[m] = m_ky[a];
+				m++;
+			}
+			combine(dst[i], h.begin(), wy.begin(), m, cols);
+		}
+	}
+
+	template<typename T>
+	void Stencil<T>::filterRow(const T* row, int n, T* h, T* ext) const
+	{
+		const int nx = m_kx.len(), rx = nx/2;
+		const T*  kx = m_kx.begin();
+		if( n < nx )
+		{
+			extend(row, n, rx, nx-1-rx, ext);
+			correlate(h, (const T*)ext, kx, nx, n);
+			return;
+		}
+		// Inner outputs read the row in place; the rx (nx-1-rx) outputs at the left
+		// (right) end read a short extended copy of that end.
+		correlate(h+rx, row, kx, nx, n-nx+1);
+		for (int x = 0; x < rx+nx-1; ++x)
+		{
+			int c = map(x-rx, n);
+			ext[x] = c < 0? T() : row[c];
+		}
+		correlate(h, (const T*)ext, kx, nx, rx);
+		const int c0 = n-nx+1;
+		for (int x = 0; x < 2*nx-2-rx; ++x)
+		{
+			int c = map(c0+x, n);
+			ext[x] = c < 0? T() : row[c];
+		}
+		correlate(h+rx+c0, (const T*)ext, kx, nx, nx-1-rx);
+	}
+
+	template<typename T>
+	void Stencil<T>::extend(const T* row, int n, int left, int right, T* ext) const
+	{
+		for (int x = 0; x < left; ++x)
+		{
+			int c = map(x-left, n);
+			ext[x] = c < 0? T() : row[c];
+		}
+		for (int j = 0; j < n; ++j)
+			ext[left+j] = row[j];
+		for (int x = 0; x < right; ++x)
+		{
+			int c = map(n+x, n);
+			ext[left+n+x] = c < 0? T() : row[c];
+		}
+	}
+
+}// End of namespace DSA
+#endif
@@ -0,0 +1,155 @@
+// ================= DSA DLL Files =====================
+// File: Stream.h
+// Binary stream for the run-time I/O (put/get) of the common class interface.
+// =======================================================
+// Note:
+// A Stream is a growable memory buffer, a file opened for reading or writing,
+// or a file mapped into memory. It has one position, as a file does: write()
+// and read() both start there, and rewind() goes back to the start.
+// get() takes a const Stream: the position is mutable.
+//
+// Memory and mapped streams hand out pointers to their bytes (view()), so the
+// arrays can load a payload in place instead of copying it (map()). Mapped pages
+// are copy-on-write: writes through such an array never reach the file. An
+// array loaded by map() refers to the stream, which must outlive it (and, for a
+// memory stream, must not be written to meanwhile).
+//
+// Bulk array records are stored in native byte order.
+//
+
+#ifndef DSA_STREAM_H
+#define DSA_STREAM_H
+#include <DSA/DSA.h>
+#include <DSA/ClassID.h>
+#include <cstddef>
+#include <type_traits>
+
+namespace DSA
+{
+	class Stream
+	{
+	public:
+		enum Mode
+		{
+			Memory, // Growable buffer (default)
+			Read,   // File, read through stdio
+			Write,  // File, written through stdio
+			Mapped  // File mapped in memory, read-only (copy-on-write pages)
+		};
+
+		DSA_Export Stream();
+		DSA_Export virtual ~Stream();
+
+		// Open a file in Read, Write or Mapped mode. The stream is closed first.
+		DSA_Export bool open(const char* path, Mode mode);
+		// Close the file (or free the buffer); the stream is an empty Memory stream again.
+		DSA_Export void close();
+
+		inline Mode mode() const { return m_mode; }
+
+		// Raw I/O at the current position
+		DSA_Export bool write(const void* src, size_t bytes);
+		DSA_Export bool read(void* dst, size_t bytes) const;
+
+		// Write zeros (pad) or skip (skipPad) up to the next multiple of "bytes" from
+		// the start of the stream
+		DSA_Export bool pad(size_t bytes = CacheLine);
+		DSA_Export bool skipPad(size_t bytes = CacheLine) const;
+
+		// The next "bytes" bytes in place, and move past them. 0 for a file stream
+		// (Read, Write) or past the end.
+		DSA_Export void* view(size_t bytes) const;
+
+		// Position
+		DSA_Export size_t tell() const;
+		DSA_Export bool   seek(size_t pos) const;
+		inline void       rewind() const { seek(0); }
+		// Size in bytes (Memory and Mapped streams)
+		inline size_t     size() const   { return m_size; }
+		// Start of the bytes (Memory and Mapped streams); CacheLine aligned
+		inline const UChar* data() const { return m_data; }
+
+		// Object I/O through the common class interface
+		template<class X> bool put(const X& obj)  { return obj.put(*this, X::IDClass::version); }
+		template<class X> bool get(X& obj) const  { return obj.get(*this, X::IDClass::version); }
+		// Load an array record in place (a copy from a file stream)
+		template<class X> bool map(X& obj) const  { return obj.map(*this); }
+
+	protected:
+		Mode            m_mode;
+		UChar*          m_data;   // Memory: aligned buffer; Mapped: the mapping
+		size_t          m_size;   // Bytes in the buffer or mapping
+		size_t          m_space;  // Memory: capacity of the buffer
+		mutable size_t  m_pos;    // Memory and Mapped position
+		void*           m_mem;    // Memory: heap block holding m_data
+		void*           m_file;   // Read/Write: FILE*; Mapped: platform handle (Windows)
+
+		// Make room for "bytes" more bytes after the position (Memory)
+		bool reserve(size_t bytes);
+
+	private:
+		// A Stream owns its file or buffer: no copies
+		Stream(const Stream&);
+		Stream& operator=(const Stream&);
+	};
+
+
+	// Header of a bulk array record. The payload (count*elemSize bytes, in the
+	// array's storage order) follows at the next CacheLine boundary of the stream,
+	// so a payload loaded in place keeps the alignment of a freshly allocated array.
+	struct ArrayHeader
+	{
+		enum { MaxDims = 8 };
+		ULong      cid;            // IDClass::CID of the container
+		ULong      elem;           // TPInfo<T>::IDClass::CID of the element
+		ULong      elemSize;       // sizeof(T)
+		ULong      nd;             // Number of dimensions
+		ULong      ld;             // Elements between row starts (the last dimension if packed)
+		ULong      layout;         // INDEXER::LAYOUTID of the storage order (0: row-major)
+		ULong      dims[MaxDims];  // Dimensions, slowest first
+		ULongLong  count;          // Elements in the payload (row padding included)
+	};
+
+	// Write the header and then the payload in one contiguous write.
+	// T must be trivially copyable (arithmetic types, PODs).
+	template<class ID, typename T>
+	bool putArray(Stream& stream, const T* data, ULongLong count, int nd, const int* dims, int ld, ULong layout = 0)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "putArray() writes the bytes of T: T must be trivially copyable");
+		if( nd < 0 || nd > ArrayHeader::MaxDims )
+			return false;
+		ArrayHeader h;
+		h.cid      = ID::CID;
+		h.elem     = TPInfo<T>::IDClass::CID;
+		h.elemSize = sizeof(T);
+		h.nd       = nd;
+		h.ld       = ld;
+		h.layout   = layout;
+		for (int k = 0; k < ArrayHeader::MaxDims; ++k)
+			h.dims[k] = k < nd? dims[k] : 0;
+		h.count    = count;
+		return stream.pad() && stream.write(&h, sizeof(h)) && stream.pad()
+			&& (count == 0 || stream.write(data, (size_t)count*sizeof(T)));
+	}
+
+	// Read and check the header of a record written by putArray<ID,T>() with the
+	// same layout (the class version is not compared), leaving the stream at the
+	// payload. The count and the dimensions must fit in an int.
+	template<class ID, typename T>
+	bool getArrayHeader(const Stream& stream, ArrayHeader& h, int nd, ULong layout = 0)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Arrays read the bytes of T: T must be trivially copyable");
+		if( !( stream.skipPad() && stream.read(&h, sizeof(h)) && stream.skipPad()
+			&& (h.cid & 0x00FFFFFF) == (ID::CID & 0x00FFFFFF)
+			&& h.elem == TPInfo<T>::IDClass::CID && h.elemSize == sizeof(T)
+			&& (int)h.nd == nd && h.layout == layout && h.count <= 0x7FFFFFFF ) )
+			return false;
+		for (int k = 0; k < nd; ++k)
+			if( h.dims[k] > 0x7FFFFFFF )
+				return false;
+		return true;
+	}
+
+} // End of namespace DSA
+
+#endif
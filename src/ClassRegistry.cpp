@@ -14,35 +14,25 @@ namespace DSA
 	// Construct the global registry hash table
 	Hash<ClassID, ClassRegistry*> ClassRegistryMethods::hashTable
 	(
-		&(ClassRegistryMethods::hashing),
-		&(ClassRegistryMethods::matching),
+		Hash<ClassID, ClassRegistry*>::Hashing(),  // HashOf<ClassID>
+		Hash<ClassID, ClassRegistry*>::Matching(), // ClassID::isSame()
 		2048,
 		2048
 	);
 
-	// Add one class registry. Issue warning if the registry cause collision in the hash table!
+	// Add one class registry. Abort if the class ID is already registered, unless allowed.
+	// Hash collisions between different IDs are harmless: entries are chained.
 	bool ClassRegistryMethods::add(ClassRegistry& reg, bool allowReRegister) 
 	{
 		static char txt[128];
-		// Run-time (DLL loading time) check on Hash collision for best DLL performance:
-		if( hashTable.collision(reg.ID) >= 0 )
+		// Run-time (DLL loading time) check on duplicated class IDs:
+		if( hashTable.find(reg.ID) && !allowReRegister ) // If found identical matched CID
 		{
-			if( !hashTable.find(reg.ID) ) // If found identical matched CID
-			{
-				snprintf(txt, sizeof(txt)/sizeof(txt[0]), "Class[%d] Library[%d]collision in class registry! Abort?", reg.ID.rnd(), reg.ID.dll());
-//MS			sprintf_s(txt, sizeof(txt)/sizeof(txt[0]), "Class[%d] Library[%d]collision in class registry! Abort?", reg.ID.rnd(), reg.ID.dll());
-				printf("Warning: %s\n", txt);
-//				if( MessageBox(NULL, txt, "Developer's Warning", MB_YESNO) == IDYES) 
-					abort();
-			}
-			else if(!allowReRegister)
-			{
-				snprintf(txt, sizeof(txt)/sizeof(txt[0]), "Class[%d] Library[%d] duplicated in class registry! Abort?!", reg.ID.rnd(), reg.ID.dll() );
-//MS				sprintf_s(txt, sizeof(txt)/sizeof(txt[0]), "Class[%d] Library[%d] duplicated in class registry! Abort?!", reg.ID.rnd(), reg.ID.dll() );
-				printf("Warning: %s\n", txt);
-//				if( MessageBox(NULL, txt, "Developer's Warning", MB_YESNO) == IDYES )
-					abort(); // Abort to avoid potential hazardous code
-			}
+			snprintf(txt, sizeof(txt)/sizeof(txt[0]), "Class[%d] Library[%d] duplicated in class registry! Abort?!", reg.ID.rnd(), reg.ID.dll() );
+//MS			sprintf_s(txt, sizeof(txt)/sizeof(txt[0]), "Class[%d] Library[%d] duplicated in class registry! Abort?!", reg.ID.rnd(), reg.ID.dll() );
+			printf("Warning: %s\n", txt);
+//			if( MessageBox(NULL, txt, "Developer's Warning", MB_YESNO) == IDYES )
+				abort(); // Abort to avoid potential hazardous code
 		}
 		Hash<ClassID, ClassRegistry*>::Entry* ent = hashTable.add(reg.ID);
 		if( ent )
@@ -0,0 +1,220 @@
+// ================= DSA DLL Files =====================
+// File: Stream.cpp
+// Data Structure and Algorithm Library
+// =======================================================
+
+#include <DSA/DSA.h>
+#include <DSA/Stream.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DSA
+{
+	Stream::Stream()
+		: m_mode(Memory), m_data(0), m_size(0), m_space(0), m_pos(0), m_mem(0), m_file(0)
+	{
+	}
+
+	Stream::~Stream()
+	{
+		close();
+	}
+
+	bool Stream::open(const char* path, Mode mode)
+	{
+		close();
+		if( mode == Read || mode == Write )
+		{
+			FILE* f = fopen(path, mode == Read? "rb" : "wb");
+			if( f == 0 )
+				return false;
+			m_file = f;
+			m_mode = mode;
+			return true;
+		}
+		if( mode != Mapped )
+			return true;
+
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+		if( file == INVALID_HANDLE_VALUE )
+			return false;
+		LARGE_INTEGER len;
+		if( ! GetFileSizeEx(file, &len) )
+		{
+			CloseHandle(file);
+			return false;
+		}
+		void* p = 0;
+		if( len.QuadPart > 0 )
+		{
+			HANDLE map = CreateFileMappingA(file, 0, PAGE_WRITECOPY, 0, 0, 0);
+			p = map? MapViewOfFile(map, FILE_MAP_COPY, 0, 0, 0) : 0;
+			if( p == 0 )
+			{
+				if( map ) CloseHandle(map);
+				CloseHandle(file);
+				return false;
+			}
+			m_file = map;
+		}
+		CloseHandle(file); // The mapping stays valid
+		m_size = (size_t)len.QuadPart;
+#else
+		int fd = ::open(path, O_RDONLY);
+		if( fd < 0 )
+			return false;
+		struct stat st;
+		if( fstat(fd, &st) != 0 )
+		{
+			::close(fd);
+			return false;
+		}
+		void* p = 0;
+		if( st.st_size > 0 )
+		{
+			p = mmap(0, (size_t)st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+			if( p == MAP_FAILED )
+			{
+				::close(fd);
+				return false;
+			}
+		}
+		::close(fd); // The mapping stays valid
+		m_size = (size_t)st.st_size;
+#endif
+		m_data = (UChar*)p;
+		m_mode = Mapped;
+		return true;
+	}
+
+	void Stream::close()
+	{
+		switch( m_mode )
+		{
+		case Read:
+		case Write:
+			if( m_file ) fclose((FILE*)m_file);
+			break;
+		case Mapped:
+#if defined(_WIN32)
+			if( m_data ) UnmapViewOfFile(m_data);
+			if( m_file ) CloseHandle((HANDLE)m_file);
+#else
+			if( m_data ) munmap(m_data, m_size);
+#endif
+			break;
+		default:
+			free(m_mem);
+			break;
+		}
+		m_mode  = Memory;
+		m_data  = 0;
+		m_size  = 0;
+		m_space = 0;
+		m_pos   = 0;
+		m_mem   = 0;
+		m_file  = 0;
+	}
+
+	bool Stream::reserve(size_t bytes)
+	{
+		if( m_pos + bytes <= m_space )
+			return true;
+		size_t space = m_space*2;
+		if( space < m_pos + bytes ) space = m_pos + bytes;
+		if( space < PageSize )      space = PageSize;
+
+		// Over-allocate one cache line to align the buffer, as Array2D does
+		void* mem = malloc(space + CacheLine);
+		if( mem == 0 )
+			return false;
+		UChar* data = (UChar*)(((uintptr_t)mem + CacheLine-1) & ~(uintptr_t)(CacheLine-1));
+		if( m_size ) memcpy(data, m_data, m_size);
+		free(m_mem);
+		m_mem   = mem;
+		m_data  = data;
+		m_space = space;
+		return true;
+	}
+
+	bool Stream::write(const void* src, size_t bytes)
+	{
+		if( m_mode == Write )
+			return fwrite(src, 1, bytes, (FILE*)m_file) == bytes;
+		if( m_mode != Memory || ! reserve(bytes) )
+			return false;
+		if( bytes ) memcpy(m_data + m_pos, src, bytes);
+		m_pos += bytes;
+		if( m_size < m_pos ) m_size = m_pos;
+		return true;
+	}
+
+	bool Stream::read(void* dst, size_t bytes) const
+	{
+		if( m_mode == Read )
+			return fread(dst, 1, bytes, (FILE*)m_file) == bytes;
+		const void* src = view(bytes);
+		if( src == 0 )
+			return bytes == 0;
+		memcpy(dst, src, bytes);
+		return true;
+	}
+
+	bool Stream::pad(size_t bytes)
+	{
+		static const UChar zeros[CacheLine] = {0};
+		size_t n = (bytes - tell()%bytes) % bytes;
+		while( n > 0 )
+		{
+			size_t k = n < sizeof(zeros)? n : sizeof(zeros);
+			if( ! write(zeros, k) )
+				return false;
+			n -= k;
+		}
+		return true;
+	}
+
+	bool Stream::skipPad(size_t bytes) const
+	{
+		size_t pos = tell();
+		return seek(pos + (bytes - pos%bytes) % bytes);
+	}
+
+	void* Stream::view(size_t bytes) const
+	{
+		if( m_mode == Read || m_mode == Write || m_pos + bytes > m_size || bytes == 0 )
+			return 0;
+		void* p = m_data + m_pos;
+		m_pos += bytes;
+		return p;
+	}
+
+	size_t Stream::tell() const
+	{
+		if( m_mode == Read || m_mode == Write )
+			return (size_t)ftell((FILE*)m_file);
+		return m_pos;
+	}
+
+	bool Stream::seek(size_t pos) const
+	{
+		if( m_mode == Read || m_mode == Write )
+			return fseek((FILE*)m_file, (long)pos, SEEK_SET) == 0;
+		if( pos > m_size )
+			return false;
+		m_pos = pos;
+		return true;
+	}
+
+} // End of namespace DSA
@@ -0,0 +1,16 @@
+// Pass/fail bookkeeping shared by the test programs: check() reports each
+// failed condition, and main() returns nFail == 0 ? 0 : 1.
+#ifndef DSA_TEST_CHECK_H
+#define DSA_TEST_CHECK_H
+#include <cstdio>
+
+static int nFail = 0;
+static void check(bool ok, const char* what)
+{
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        nFail++;
+    }
+}
+
+#endif
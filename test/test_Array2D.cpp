@@ -1,7 +1,160 @@
 #include <iostream>
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <DSA/Array2D.h>
+#include "TestCheck.h"
+using namespace DSA;
 
 int main() {
-    // Test code to be filled in
+    std::printf("Test Array2D<float> row stride \n");
+    Array2D<float> a(5, 1024);
+    check(a.rows() == 5 && a.cols() == 1024, "dimensions");
+    check(a.ld() >= a.cols(), "ld >= cols");
+    check((a.ld() * sizeof(float)) % PageSize != 0, "no 4K aliasing stride");
+    for (int i = 0; i < a.rows(); ++i)
+        check(((uintptr_t)a[i]) % CacheLine == 0, "row aligned to cache line");
 
-    return 0;
+    Array2D<double> b(3, 7);
+    check(b.ld() == 7, "7 doubles stay packed");
+    Array2D<double> w(3, 37);
+    check(w.ld() == 40, "37 doubles padded to whole cache lines");
+    for (int i = 0; i < b.rows(); ++i)
+        for (int j = 0; j < b.cols(); ++j)
+            b[i][j] = i * 10 + j;
+    double mn = 0, mx = 0;
+    b.getMinMax(mn, mx);
+    check(mn == 0 && mx == 26, "getMinMax");
+    w = 2.0;
+    w[2][36] = 3.0;
+    w.getMinMax(mn, mx);
+    check(mn == 2.0 && mx == 3.0, "getMinMax skips padding");
+    Array2D<int> iv(2, 3);
+    iv = 4;
+    iv[1][2] = -9;
+    int imn = 0, imx = 0;
+    iv.getMinMax(imn, imx);
+    check(imn == -9 && imx == 4, "getMinMax of int");
+
+    Array2D<double> c(b);
+    check(c.element(2, 6) == 26 && c[1][3] == 13, "copy construct");
+    c = 1.5;
+    check(c[2][6] == 1.5 && b[2][6] == 26, "assign value");
+
+    Array2D<int, 2, 3> s;
+    s[1][2] = 7;
+    check(s.ld() == 3 && s.element(1, 2) == 7, "static buffer is packed");
+
+    std::printf("Test Array2D<int>::resize keeps (i,j) \n");
+    Array2D<int> r(4, 5, 4096);
+    for (int i = 0; i < r.rows(); ++i)
+        for (int j = 0; j < r.cols(); ++j)
+            r[i][j] = i * 100 + j;
+    const int* block = r.begin();
+    bool ok = r.resize(6, 40);                      // wider stride, in place
+    check(ok && r.begin() == block, "in-place column growth");
+    ok = true;
+    for (int i = 0; i < 6; ++i)
+        for (int j = 0; j < 40; ++j)
+            ok = ok && r[i][j] == ((i < 4 && j < 5) ? i * 100 + j : 0);
+    check(ok, "contents after column growth");
+    r.resize(3, 2);                                 // shrink both
+    check(r[2][1] == 201 && r[0][0] == 0, "contents after shrink");
+    r.resize(200, 300);                             // relocation
+    check(r.begin() != block && r[2][1] == 201 && r[1][0] == 100 && r[199][299] == 0, "relocation");
+
+    std::printf("Test Array2D<float> Morton and tiled layouts \n");
+    Array2D<float, 0, 0, MortonIndexer> z(20, 37);
+    Array2D<float, 0, 0, TileIndexer> t(20, 37);
+    for (int i = 0; i < z.rows(); ++i)
+        for (int j = 0; j < z.cols(); ++j) {
+            z(i, j) = i * 100.f + j;
+            t(i, j) = i * 100.f + j;
+        }
+    ok = true;
+    for (int i = 0; i < z.rows(); ++i)
+        for (int j = 0; j < z.cols(); ++j) {
+            int ii = -1, jj = -1;
+            z.layout().coords(z.layout()(i, j), ii, jj);
+            ok = ok && ii == i && jj == j && z(i, j) == t(i, j);
+            t.layout().coords(t.layout()(i, j), ii, jj);
+            ok = ok && ii == i && jj == j;
+        }
+    check(ok, "layout round trip");
+    check(&z(9, 9) - &z(8, 8) == 3 && &t(9, 9) - &t(8, 8) == 9, "2x2 block neighbours are close");
+    int nTile = 0;
+    float sum = 0;
+    t.forEachTile([&](const Array2D<float, 0, 0, TileIndexer>::Tile& tl) {
+        nTile++;
+        for (int r = 0; r < tl.rows; ++r)
+            for (int c = 0; c < tl.cols; ++c)
+                sum += tl(r, c) - tl.data[r * 8 + c] + 1;
+    });
+    check(nTile == 3 * 5 && sum == 20 * 37, "forEachTile");
+    float zmin = 0, zmax = 0;
+    z.resize(10, 50);
+    z.getMinMax(zmin, zmax);
+    check(z(9, 36) == 936 && z(9, 49) == 0 && zmin == 0 && zmax == 936, "layout resize");
+
+    std::printf("Test Array2D<double> row/column reductions \n");
+    setNumThreads(4);
+    Array2D<double> m(1000, 301);
+    for (int i = 0; i < m.rows(); ++i)
+        for (int j = 0; j < m.cols(); ++j)
+            m[i][j] = (double)((i * 31 + j * 17) % 101) - 50;
+    m[500][7] = 1000;
+    m[900][7] = 1000;                               // tie: first row wins
+    m[3][4] = NAN;
+    Array<double> rs, cs, rmax, cmin, n2, ninf;
+    Array<int> amax, amin;
+    check(m.reduceRows(rs, ReduceSum<double>()) && m.reduceCols(cs, ReduceSum<double>()), "sums");
+    m.reduceRows(rmax, ReduceMax<double>());
+    m.reduceCols(cmin, ReduceMin<double>());
+    m.reduceCols(amax, ReduceArgMax<double>());
+    m.reduceRows(amin, ReduceArgMin<double>());
+    m.reduceRows(n2, ReduceNorm2<double>());
+    m.reduceCols(ninf, ReduceNormInf<double>());
+    ok = rs.len() == 1000 && cs.len() == 301;
+    for (int i = 0; i < m.rows() && ok; ++i) {
+        double s = 0, mx = -1e9, q = 0;
+        int am = -1;
+        for (int j = 0; j < m.cols(); ++j) {
+            s += m[i][j];
+            q += m[i][j] * m[i][j];
+            if (m[i][j] == m[i][j] && (am < 0 || m[i][j] < m[i][am])) am = j;
+            if (m[i][j] > mx) mx = m[i][j];
+        }
+        ok = (i == 3 || (rs[i] == s && std::fabs(n2[i] - std::sqrt(q)) < 1e-9)) && rmax[i] == mx && amin[i] == am;
+    }
+    check(ok, "row reductions");
+    ok = true;
+    for (int j = 0; j < m.cols() && ok; ++j) {
+        double s = 0, mn = 1e9, mi = 0;
+        int am = -1;
+        for (int i = 0; i < m.rows(); ++i) {
+            s += m[i][j];
+            if (m[i][j] < mn) mn = m[i][j];
+            if (std::fabs(m[i][j]) > mi) mi = std::fabs(m[i][j]);
+            if (m[i][j] == m[i][j] && (am < 0 || m[i][j] > m[am][j])) am = i;
+        }
+        ok = (j == 4 || (cs[j] == s && ninf[j] == mi)) && cmin[j] == mn && amax[j] == am;
+    }
+    check(ok && amax[7] == 500, "column reductions");
+    m.applyRows([](int i, double* row, int n) {
+        for (int j = 0; j < n; ++j) row[j] = i;
+    });
+    m.reduceCols(cs, ReduceSum<double>());
+    check(cs[0] == 999.0 * 1000 / 2 && cs[300] == cs[0], "applyRows");
+
+    std::cout << "Array2D stride: cols=" << a.cols() << " ld=" << a.ld() << std::endl;
+    // Array2D as a strided view: one run when packed, one run per row when padded
+    Array2D<float> vp(4, 16), vq(4, 100);
+    int nRun = 0;
+    for (RunIterator<float, 2> it(vp.view()); it; ++it) nRun++;
+    check(vp.ld() == vp.cols() && nRun == 1, "packed Array2D is one run");
+    nRun = 0;
+    for (RunIterator<float, 2> it(vq.view()); it; ++it) nRun += it.n == 100;
+    check(vq.ld() > vq.cols() && nRun == 4, "padded Array2D has a run per row");
+
+    return nFail == 0 ? 0 : 1;
 }
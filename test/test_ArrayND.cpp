@@ -0,0 +1,204 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <DSA/ArrayND.h>
+#include "TestCheck.h"
+using namespace DSA;
+
+int main() {
+    std::printf("Test ArrayND<int,2> with Morton and tiled indexers \n");
+    ArrayND<int, 2, MortonIndexer> m(16, 16);
+    ArrayND<int, 2, TileIndexer> t(16, 16);
+    check(m.size == 256 && t.size == 256, "storage size");
+    for (int i = 0; i < 16; ++i)
+        for (int j = 0; j < 16; ++j) {
+            m(i, j) = i * 16 + j;
+            t(i, j) = i * 16 + j;
+        }
+    bool ok = true;
+    for (int i = 0; i < 16; ++i)
+        for (int j = 0; j < 16; ++j)
+            ok = ok && m(i, j) == i * 16 + j && t(i, j) == i * 16 + j;
+    check(ok, "element access");
+    check(m.data[3] == 17 && t.data[8] == 16, "storage order");
+
+    ArrayND<int, 2, MortonIndexer> c(m);
+    check(c(15, 15) == 255, "copy construct");
+    c = 7;
+    check(c(3, 4) == 7 && m(3, 4) == 52, "assign value");
+
+    std::printf("Test ArrayND row-major strides, 1-D to 5-D \n");
+    ArrayND<int, 3> a3(2, 3, 4);
+    check(a3.idx.s[0] == 12 && a3.idx.s[1] == 4 && a3.idx.s[2] == 1 && a3.size == 24, "3-D strides");
+    for (int i = 0; i < 2; ++i)
+        for (int j = 0; j < 3; ++j)
+            for (int k = 0; k < 4; ++k) a3(i, j, k) = i * 100 + j * 10 + k;
+    check(a3.data[23] == 123 && a3.data[4] == 10 && &a3(1, 0, 0) - a3.data == 12, "3-D layout");
+    ArrayND<double, 5> a5(2, 3, 1, 4, 5);
+    a5 = 0.0;
+    a5(1, 2, 0, 3, 4) = 9;
+    check(a5.size == 120 && a5.data[119] == 9 && a5.dim(4) == 5, "5-D");
+    ArrayND<int, 1> a1(7);
+    a1(6) = 1;
+    check(a1.data[6] == 1 && a1.idx.space() == 7, "1-D");
+    check(!a3.resize(2, -1, 4), "negative dimension");
+
+    std::printf("Test ArrayND with compile-time Extents \n");
+    typedef Extents<8, 8, 3> Pixels;
+    ArrayND<float, 3, Pixels::Indexer> px;
+    check(px.resize(8, 8, 3) && !px.resize(8, 8, 4) && px.size == 192, "fixed extents");
+    static_assert(Pixels::Indexer<3>::space() == 192, "space is a constant");
+    for (int i = 0; i < 8; ++i)
+        for (int j = 0; j < 8; ++j)
+            for (int c = 0; c < 3; ++c) px(i, j, c) = (float)(i * 24 + j * 3 + c);
+    ok = true;
+    for (int k = 0; k < 192; ++k) ok = ok && px.data[k] == k;
+    check(ok && px.idx(7, 7, 2) == 191 && px.d2() == 8, "fixed extents layout");
+    const ArrayND<float, 3, Pixels::Indexer>& cpx = px;
+    check(cpx(1, 2, 0) == 30, "const access");
+
+    std::printf("Test ArrayNDView slicing, permutation and broadcasting \n");
+    ArrayND<float, 3> img(6, 10, 3);
+    for (int i = 0; i < 6; ++i)
+        for (int j = 0; j < 10; ++j)
+            for (int c = 0; c < 3; ++c) img(i, j, c) = i * 100.f + j * 10.f + c;
+    ArrayNDView<float, 3> all = img.view();
+    ArrayNDView<float, 3> green = all.slice(2, 1, 2);
+    ArrayNDView<float, 2> g2 = all.select(2, 1);
+    check(green.d[2] == 1 && green(4, 7, 0) == 471 && g2(4, 7) == 471 && !green.isContiguous(), "channel slice");
+    ArrayNDView<float, 3> sub = all.slice(0, 1, 6, 2).slice(1, 3, 9, 3);
+    check(sub.d[0] == 3 && sub.d[1] == 2 && sub(2, 1, 2) == 562 && sub.count() == 18, "stepped slice");
+    ArrayNDView<float, 3> chw = all.permute(2, 0, 1);
+    check(chw.d[0] == 3 && chw.d[1] == 6 && chw(2, 5, 9) == 592, "permute");
+    check(all.isContiguous() && all.count() == 180, "whole view");
+
+    ArrayND<float, 3> bias(1, 10, 1);
+    for (int j = 0; j < 10; ++j) bias(0, j, 0) = -10.f * j;
+    check(green.add(bias.view()) && img(5, 9, 1) == 501 && img(5, 9, 0) == 590, "broadcast add on a slice");
+    ArrayND<float, 3> row(1, 1, 3);
+    check(!green.add(row.view()), "shape mismatch");
+
+    ArrayND<float, 3> out(6, 10, 3), two(6, 10, 3);
+    two = 2.f;
+    ArrayNDView<float, 3> ov = out.view();
+    ov.fill(1.f);
+    check(ov.axpy(0.5f, two.view()) && ov.mul(two.view()) && out(3, 3, 2) == 4.f, "contiguous kernels");
+    ArrayND<int, 3> itwo(6, 10, 3);
+    itwo = 2;
+    ov.fill(1.f);
+    check(ov.add(itwo.view()) && out(4, 5, 1) == 3.f && ov.axpy(2.f, itwo.view()) && out(0, 9, 2) == 7.f,
+          "add/axpy convert a source of another type");
+    check(ov.copy(chw.permute(1, 2, 0)) && out(5, 9, 0) == 590 && out(2, 3, 1) == 201, "copy a permuted view");
+    ArrayND<float, 3> planar(3, 6, 10);
+    planar.view().copy(chw);
+    check(planar(1, 5, 9) == 501 && planar(0, 2, 3) == 230, "materialize HWC as CHW");
+    int dims[3] = {6, 10, 3};
+    ArrayNDView<const float, 3> b = bias.view();
+    check(b.broadcast(dims) && b(5, 4, 2) == -40.f && b.s[0] == 0, "explicit broadcast");
+    float sum = 0;
+    ov.apply(b, [&](float& x, const float& y) { x = y; sum += y; });
+    check(sum == -450.f * 18 && out(0, 9, 2) == -90.f, "apply");
+
+    std::printf("Test ArrayND<float,3> with 8x8x8 bricks \n");
+    ArrayND<float, 3, TileIndexer> vol(20, 17, 9);
+    check(vol.size == 3 * 3 * 2 * 512, "padded to whole bricks");
+    for (int i = 0; i < 20; ++i)
+        for (int j = 0; j < 17; ++j)
+            for (int k = 0; k < 9; ++k) vol(i, j, k) = i * 10000.f + j * 100.f + k;
+    ok = &vol(1, 1, 1) - &vol(0, 0, 0) == 73 && &vol(0, 0, 8) - &vol(0, 0, 0) == 512 && &vol(8, 0, 0) - &vol(0, 0, 0) == 6 * 512;
+    for (int i = 0; i < 20 && ok; ++i)
+        for (int j = 0; j < 17; ++j)
+            for (int k = 0; k < 9; ++k) {
+                int c[3];
+                vol.idx.coords(vol.idx(i, j, k), c);
+                ok = ok && c[0] == i && c[1] == j && c[2] == k;
+            }
+    check(ok, "brick layout round trip");
+    int nBrick = 0, nElem = 0;
+    ok = true;
+    vol.forEachBrick([&](const TileIndexer<3>::Brick& b, float* p) {
+        nBrick++;
+        for (int r0 = 0; r0 < b.n[0]; ++r0)
+            for (int r1 = 0; r1 < b.n[1]; ++r1)
+                for (int r2 = 0; r2 < b.n[2]; ++r2) {
+                    nElem++;
+                    ok = ok && p[b(r0, r1, r2)] == (b.i0[0] + r0) * 10000.f + (b.i0[1] + r1) * 100.f + b.i0[2] + r2;
+                }
+    });
+    check(ok && nBrick == 18 && nElem == 20 * 17 * 9, "forEachBrick");
+    int ii, jj;
+    TileIndexer<2> t2;
+    t2.set(20, 37);
+    t2.coords(t2(13, 30), ii, jj);
+    check(ii == 13 && jj == 30 && t2(9, 9) - t2(8, 8) == 9, "2-D tiles");
+
+    std::printf("Test ArrayND axis reductions and forEachIndex \n");
+    setNumThreads(3);
+    ArrayND<double, 3> cube(40, 300, 500);
+    cube.forEachIndex([](const int* i, double* p, int ps, int n) {
+        for (int k = 0; k < n; ++k) p[k * ps] = (double)((i[0] * 7 + i[1] * 3 + k) % 11);
+    });
+    check(cube(3, 5, 7) == (3 * 7 + 5 * 3 + 7) % 11, "forEachIndex");
+    ok = true;
+    for (int axis = 0; axis < 3; ++axis) {
+        ArrayND<double, 3> s3, mx, mn;
+        ArrayND<int, 3> am;
+        ok = ok && cube.sum(axis, s3) && cube.max(axis, mx) && cube.mean(axis, mn)
+                && cube.reduce(axis, am, ReduceArgMax<double>()) && s3.dim(axis) == 1;
+        for (int a = 0; a < 40 && ok; a += 13)
+            for (int b = 0; b < 300 && ok; b += 37)
+                for (int c = 0; c < 500 && ok; c += 41) {
+                    int i[3] = {a, b, c};
+                    i[axis] = 0;
+                    double sum = 0, best = -1;
+                    int arg = -1;
+                    for (int k = 0; k < cube.dim(axis); ++k) {
+                        int j[3] = {i[0], i[1], i[2]};
+                        j[axis] = k;
+                        double v = cube(j[0], j[1], j[2]);
+                        sum += v;
+                        if (v > best) { best = v; arg = k; }
+                    }
+                    ok = s3(i[0], i[1], i[2]) == sum && mx(i[0], i[1], i[2]) == best && am(i[0], i[1], i[2]) == arg
+                         && std::fabs(mn(i[0], i[1], i[2]) - sum / cube.dim(axis)) < 1e-12;
+                }
+    }
+    check(ok, "sum/max/mean/argmax along each axis");
+    ArrayND<double, 3> ch(1, 300, 1);
+    check(!cube.view().slice(2, 10, 500, 7).reduce(0, ch.view(), ReduceMin<double>()), "reduce checks the output shape");
+    ArrayND<double, 3> cs(40, 300, 1);
+    cs = -1.0;
+    ok = cube.view().slice(2, 4, 5).reduce(1, cs.view().slice(1, 0, 1), ReduceSum<double>());
+    for (int a = 0; a < 40 && ok; ++a) {
+        double sum = 0;
+        for (int b = 0; b < cube.dim(1); ++b) sum += cube(a, b, 4);
+        ok = cs(a, 0, 0) == sum && cs(a, 1, 0) == -1.0; // only the sliced output is written
+    }
+    check(ok, "reduce a strided view");
+
+    // Runs in memory order, with dimensions coalesced
+    ArrayND<float, 3> rv(6, 7, 8);
+    int nRun = 0, nRunElem = 0;
+    for (RunIterator<float, 3> it(rv.view()); it; ++it) { nRun++; nRunElem += it.n; }
+    check(nRun == 1 && nRunElem == 6 * 7 * 8, "packed array is one run");
+    nRun = 0;
+    for (RunIterator<float, 3> it(rv.view().slice(1, 0, 7, 2)); it; ++it) { nRun++; ok = it.n == 8 && it.ps == 1; }
+    check(ok && nRun == 6 * 4, "sliced view runs along the last dimension");
+    RunIterator<float, 3> rs(rv.view().slice(1, 2, 3));
+    check(rs.dims() == 2 && rs.n == 8, "size-1 dimension dropped");
+    for (int k = 0; k < 6 * 7 * 8; ++k) rv.data[k] = (float)k;
+    float last = -1;
+    nRun = 0;
+    ok = true;
+    for (RunIterator<float, 3> it(rv.view().permute(2, 0, 1)); it; ++it, ++nRun)
+        for (int j = 0; j < it.n; ++j) { ok = ok && it.p[j * it.ps] > last; last = it.p[j * it.ps]; }
+    check(ok && nRun == 1, "permuted view walked in memory order");
+    ArrayND<float, 3> rb(1, 7, 1);
+    rb.view().fill(2.0f);
+    RunIterator<float, 3> rq(rv.view(), rb.view());
+    check(rq.qs == 0 && rq.n == 8 && rq.dims() == 3, "broadcast source strides");
+    check(rv.view().add(rb.view()) && rv(5, 6, 7) == 6 * 7 * 8 - 1 + 2.0f, "add through runs");
+
+    std::cout << "ArrayND Morton (1,1) at offset " << m.idx(1, 1) << std::endl;
+    return nFail == 0 ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <cstdio>
+#include <thread>
+#include <DSA/ConcurrentLists.h>
+#include "TestCheck.h"
+using namespace DSA;
+
+int main() {
+    std::printf("Test ConcurrentLists<int> lock-free inserts \n");
+    const int NT = 4, N = 50000, NL = 8;
+    ConcurrentLists<int> cl;
+    check(cl.alloc(NT * N, NL) && cl.totalSpace() == NT * N, "alloc");
+
+    // Every thread inserts its own values into all the (shared) lists
+    std::thread th[NT];
+    for (int t = 0; t < NT; ++t)
+        th[t] = std::thread([&cl, t]() {
+            for (int k = 0; k < N; ++k) cl.insert(t * N + k, k % NL);
+        });
+    for (int t = 0; t < NT; ++t) th[t].join();
+    check(cl.numEntries() == NT * N && !cl.insert(-1, 0), "all inserted, then full");
+
+    char* seen = new char[NT * N]();
+    bool ok = true;
+    int lastOfThread[NL][NT];
+    for (int i = 0; i < NL; ++i) {
+        int n = 0;
+        for (int t = 0; t < NT; ++t) lastOfThread[i][t] = NT * N;
+        for (int k = cl.first(i); k >= 0; k = cl.nextOf(k), ++n) {
+            int v = cl.objOf(k), t = v / N;
+            ok = ok && v % N % NL == i && !seen[v] && v < lastOfThread[i][t]; // push-front: each thread's values descend
+            seen[v] = 1;
+            lastOfThread[i][t] = v;
+        }
+        ok = ok && n == cl.length(i) && n == NT * N / NL;
+    }
+    check(ok, "every object once, on its list, in insertion order per thread");
+
+    // Quiescent phase: compact, clear, reuse
+    int before = cl.objOf(cl.first(3));
+    check(cl.compact() && cl.objOf(cl.first(3)) == before, "compact keeps the order");
+    ok = true;
+    for (int i = 0; i < NL; ++i) {
+        int k0 = cl.first(i), n = 0;
+        for (int k = k0; k >= 0; k = cl.nextOf(k), ++n) ok = ok && k == k0 + n;
+    }
+    check(ok, "compacted lists are contiguous");
+    cl.clearList(5);
+    check(cl.length(5) == 0 && cl.first(5) < 0 && cl.insert(7, 5) && cl.objOf(cl.first(5)) == 7, "clearList frees the entries");
+    check(cl.reserve(NT * N + 100) && cl.insert(9, 0) && cl.objOf(cl.first(0)) == 9 && cl.length(3) == NT * N / NL, "reserve keeps the lists");
+    delete[] seen;
+
+    return nFail == 0 ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <map>
+#include <DSA/Hash.h>
+#include <DSA/OpenHash.h>
+#include "TestCheck.h"
+using namespace DSA;
+
+// Tables of int labels hashed and matched through functions
+typedef OpenHash<int, int, HashFunction<int>, MatchFunction<int> > FunctionOpenHash;
+typedef Hash<int, int, ListsAoS, HashFunction<int>, MatchFunction<int> > FunctionHash;
+
+static int hashInt(int const& k) { return k * 2654435761u >> 8; }
+static bool matchInt(int const& a, int const& b) { return a == b; }
+// A weak hash: every key of a residue class collides
+static int hashMod(int const& k) { return k % 13; }
+
+// A label without a built-in hash (nor ==)
+struct Pair { int a, b; };
+static int hashPair(Pair const& p) { return p.a * 31 + p.b; }
+static bool matchPair(Pair const& x, Pair const& y) { return x.a == y.a && x.b == y.b; }
+
+static int hashStr(const char* const& s) { unsigned h = 0; for (const char* p = s; *p; ++p) h = h * 31 + *p; return (int)h; }
+static bool matchStr(const char* const& a, const char* const& b) { return std::strcmp(a, b) == 0; }
+
+int main() {
+    std::printf("Test Hash and OpenHash against std::map \n");
+    FunctionOpenHash oh(hashInt, matchInt, 16);
+    std::map<int, int> ref;
+    bool ok = oh.getHashSize() == 32 && oh.getNumMaxEntry() >= 16;
+    unsigned r = 12345;
+    for (int k = 0; k < 20000; ++k) {
+        r = r * 1103515245u + 12345u;
+        int key = (int)(r >> 16) % 3000, op = (r >> 8) & 3;
+        if (op == 0) {
+            ok = ok && oh.del(key) == (ref.erase(key) == 1);
+        } else if (op == 1) {
+            int* c = oh[key];
+            std::map<int, int>::iterator it = ref.find(key);
+            ok = ok && (c ? it != ref.end() && *c == it->second : it == ref.end());
+        } else {
+            ok = ok && oh.add(key, k);
+            ref[key] = k;
+        }
+    }
+    ok = ok && oh.getNumEntries() == (int)ref.size();
+    for (std::map<int, int>::iterator it = ref.begin(); it != ref.end(); ++it)
+        ok = ok && oh.findContent(it->first) && *oh.findContent(it->first) == it->second;
+    check(ok, "random add/del/find");
+
+    // add(label) returns the existing entry; add(Entry) logs duplicates
+    FunctionOpenHash dup(hashMod, matchInt, 4);
+    HashEntry<int, int>* e = dup.add(5);
+    ok = e && e->label == 5 && e->content == 0 && dup.add(5) == e;
+    e->content = 7;
+    for (int k = 0; k < 3; ++k) ok = ok && dup.add(HashEntry<int, int>(18, k));
+    Array<HashEntry<int, int> > all;
+    ok = ok && dup.findAll(18, all) && all.len() == 3 && !dup.findAll(31, all);
+    check(ok && dup.getNumEntries() == 4 && *dup[5] == 7 && dup.collision(5) >= 0, "duplicates");
+    // Many colliding keys, deleted and re-added: probes go past tombstones
+    for (int k = 0; k < 400; ++k) ok = ok && dup.add(k * 13 + 1, k);
+    for (int k = 0; k < 400; k += 2) ok = ok && dup.del(k * 13 + 1);
+    for (int k = 1; k < 400; k += 2) ok = ok && *dup[k * 13 + 1] == k;
+    for (int k = 0; k < 400; k += 2) ok = ok && !dup.find(k * 13 + 1) && dup.add(k * 13 + 1, -k);
+    check(ok && dup.getNumEntries() == 404 && *dup[13 * 200 + 1] == -200, "colliding keys");
+
+    OpenHash<const char*, int, HashFunction<const char*>, MatchFunction<const char*> > names(hashStr, matchStr, 4);
+    const char* word[] = { "alpha", "beta", "gamma", "delta", "epsilon" };
+    for (int k = 0; k < 5; ++k) names.add(word[k], k);
+    char key[8] = "gamma";
+    OpenHash<std::string, int> bn;
+    for (int k = 0; k < 5; ++k) bn.add(word[k], k);
+    check(names.find(key) && *names[key] == 2 && !names.find("zeta") && *bn[std::string("beta")] == 1, "string keys");
+
+    // Hash grows its buckets with the entries, a few buckets per add
+    Hash<int, int> gh;
+    ok = gh.hashSize() == 16 && gh.add(1, 1) && *gh[1] == 1 && !gh.find(2);
+    int maxChain = 0;
+    for (int k = 0; k < 100000; ++k) {
+        ok = ok && gh.add(k, k);
+        if (k % 2 == 0 && k > 10) ok = ok && gh.del(k / 2);
+    }
+    ok = ok && gh.add(1, -1) && *gh[1] == -1; // replaces the content
+    for (unsigned int b = 0; b < gh.hashSize(); ++b)
+        if (gh.getChainLength(b) > maxChain) maxChain = gh.getChainLength(b);
+    check(ok && gh.getNumEntries() <= gh.maxLoadFactor() * gh.hashSize() && maxChain < 16, "bucket doubling");
+    ok = true;
+    for (int k = 0; k < 100000; ++k)
+        ok = ok && (k > 5 && k < 50000 ? !gh.find(k) : gh.find(k) && gh.find(k)->label == k);
+    check(ok && gh.getNumEntries() == 50006, "entries found after rehashing");
+
+    Hash<int, int> sh;
+    sh.setIncrementalRehash(false);
+    ok = sh.reserve(5000) && sh.hashSize() >= 5000 && !sh.isRehashing();
+    unsigned int reserved = sh.hashSize();
+    for (int k = 0; k < 5000; ++k) ok = ok && sh.add(k * 5, k);
+    ok = ok && sh.hashSize() == reserved;
+    for (int k = 100; k < 5000; ++k) ok = ok && sh.del(k * 5);
+    ok = ok && sh.shrinkToFit() && sh.hashSize() == 128 && sh.getHashSize() == 128;
+    for (int k = 0; k < 5000; ++k) ok = ok && (k < 100) == (sh.find(k * 5) != 0);
+    check(ok && *sh[495] == 99, "reserve and shrinkToFit");
+
+    // Built-in policies for strings and ClassIDs; function pointers through adapters
+    Hash<std::string, int> sn;
+    Hash<const char*, int> cn;
+    Hash<ClassID, int> id;
+    FunctionHash fh(hashMod, matchInt, 16, 16);
+    for (int k = 0; k < 5; ++k) {
+        sn.add(word[k], k);
+        cn.add(word[k], k);
+        id.add(ClassID(0x01000000 | (k * 977), k & 1), k);
+    }
+    for (int k = 0; k < 1000; ++k) fh.add(k, -k);
+    ok = *sn[std::string("delta")] == 3 && *cn[key] == 2 && !cn.find("zeta") && fh.getNumEntries() == 1000;
+    ok = ok && *id[ClassID(0x05000000 | (3 * 977), 1)] == 3 && !id.find(ClassID(3 * 977, 0)); // version ignored
+    for (int k = 0; k < 1000; ++k) ok = ok && *fh[k] == -k;
+    check(ok, "hash policies");
+    Hash<Pair, int> pr(hashPair, matchPair, 16, 16);
+    for (int k = 0; k < 100; ++k) { Pair p = {k, -k}; pr.add(p, k); }
+    Pair p5 = {5, -5}, p6 = {6, 5};
+    check(*pr[p5] == 5 && !pr.find(p6) && pr.getNumEntries() == 100, "hash and matching functions of a custom label");
+
+    // Lookups in a table larger than the caches
+    const int N = 1 << 20;
+    Hash<int, int, ListsAoS, HashOf<int>, EqualTo<int> > ch(HashOf<int>(), EqualTo<int>(), N, N);
+    FunctionHash ph(hashInt, matchInt, N, N);
+    OpenHash<int, int, HashOf<int>, EqualTo<int> > op(HashOf<int>(), EqualTo<int>(), N);
+    for (int k = 0; k < N; ++k) {
+        ch.add(k * 3, k);
+        ph.add(k * 3, k);
+        op.add(k * 3, k);
+    }
+    long sum0 = 0, sum1 = 0, sum2 = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < 2 * N; ++k) { int* c = ph[(int)((k * 7919u) % (3u * N))]; sum0 += c ? *c : 0; }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int k = 0; k < 2 * N; ++k) { int* c = ch[(int)((k * 7919u) % (3u * N))]; sum1 += c ? *c : 0; }
+    auto t2 = std::chrono::steady_clock::now();
+    for (int k = 0; k < 2 * N; ++k) { int* c = op[(int)((k * 7919u) % (3u * N))]; sum2 += c ? *c : 0; }
+    auto t3 = std::chrono::steady_clock::now();
+    check(sum0 == sum1 && sum1 == sum2 && op.getNumEntries() == N, "same lookups as Hash");
+    std::printf("  %d lookups: Hash with function pointers %.1f ms, with HashOf<int> %.1f ms, OpenHash with HashOf<int> %.1f ms\n", 2 * N,
+                std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                std::chrono::duration<double, std::milli>(t2 - t1).count(),
+                std::chrono::duration<double, std::milli>(t3 - t2).count());
+
+    return nFail == 0 ? 0 : 1;
+}
@@ -0,0 +1,361 @@
+#include <iostream>
+#include <cstdio>
+#include <chrono>
+#include <list>
+#include <vector>
+#include <DSA/List.h>
+#include <DSA/Hash.h>
+#include "TestCheck.h"
+using namespace DSA;
+
+// Objects of list #i, front to back, compared with the expected ones
+static bool listIs(Lists<double>& l, int i, const double* expect, int n)
+{
+    int k = 0;
+    for (Lists<double>::LinkNext* o = l.getList(i); o; o = l.getNext(*o), ++k)
+        if (k >= n || o->obj != expect[k]) return false;
+    Lists<double>::LinkNext* last = l.getLast(i);
+    return k == n && (n == 0 ? last == 0 : last && last->obj == expect[n - 1] && last->next < 0);
+}
+
+static int hashInt(int const& k) { return k * 2654435761u >> 8; }
+static bool matchInt(int const& a, int const& b) { return a == b; }
+
+// A large object with a small key, as a hash entry
+struct Big {
+    int key;
+    double payload[15];
+    bool operator==(const Big& b) const { return key == b.key; }
+};
+
+int main() {
+    std::printf("Test Lists<double> tail cursors, counts and growth \n");
+    bool ok = true;
+    auto t0 = std::chrono::steady_clock::now(), t1 = t0;
+    Lists<double> l;
+    check(l.alloc(4, 3), "alloc");
+    double* p = l.insertAtEnd(0);
+    check(p != 0, "insertAtEnd(i) returns a slot");
+    if (p) *p = 1;
+    check(l.insertAtEnd(2, 0) && l.insertAtEnd(3, 0), "insertAtEnd(o) returns true");
+    const double e0[] = {1, 2, 3};
+    check(listIs(l, 0, e0, 3), "appended in order");
+    check(l.insert(0, 0), "insert at front");
+    l.insertAtEnd(4, 0); // grows the log
+    const double e1[] = {0, 1, 2, 3, 4};
+    check(listIs(l, 0, e1, 5), "append after growing the log");
+    check(l.remove(4, 0), "remove the last object");
+    const double e2[] = {0, 1, 2, 3};
+    check(listIs(l, 0, e2, 4), "tail follows remove");
+    l.insert(7, 1);
+    l.insertAtEnd(8, 1);
+    check(l.splice(0, 1) && l.getList(1) == 0 && l.getLast(1) == 0, "splice empties the source list");
+    const double e3[] = {0, 1, 2, 3, 7, 8};
+    check(listIs(l, 0, e3, 6), "splice appends");
+    check(l.splice(2, 0) && listIs(l, 2, e3, 6) && listIs(l, 0, e3, 0), "splice onto an empty list");
+    l.popNext(*l.getList(2), 2);
+    const double e4[] = {0, 2, 3, 7, 8};
+    check(listIs(l, 2, e4, 5), "popNext");
+    while (l.getList(2)) l.popList(2);
+    check(l.getLast(2) == 0, "popList to empty");
+    l.insertAtEnd(9, 2);
+    const double e5[] = {9};
+    check(listIs(l, 2, e5, 1), "append after popping to empty");
+    l.popNext(*l.getList(2), 2);
+    check(listIs(l, 2, e5, 1), "popNext at the tail is a no-op");
+
+    // Counts follow every insert, pop, remove and splice
+    Lists<double> c;
+    c.alloc(8, 4);
+    for (int k = 0; k < 10; ++k) c.insert(k, k % 4);
+    c.insertAtEnd(10, 3);
+    check(c.length(0) == 3 && c.length(1) == 3 && c.length(2) == 2 && c.length(3) == 3 && c.numEntries() == 11, "lengths");
+    c.popList(0);
+    c.popNext(*c.getList(1), 1);
+    c.remove(10, 3);
+    check(c.length(0) == 2 && c.length(1) == 2 && c.length(3) == 2 && c.numEntries() == 8, "lengths after pop and remove");
+    c.popList(4);
+    c.popList(-1);
+    c.popNext(*c.getList(0), 7);
+    check(c.numEntries() == 8 && c.length(0) == 2, "pops on a list out of range are no-ops");
+    c.splice(2, 3);
+    check(c.length(2) == 4 && c.length(3) == 0 && c.numEntries() == 8, "lengths after splice");
+    int space = c.totalSpace();
+    c.clearList(2);
+    c.clearList(2);
+    check(c.length(2) == 0 && c.getList(2) == 0 && c.getLast(2) == 0 && c.numEntries() == 4, "clearList");
+    for (int k = 0; k < 4; ++k) c.insertAtEnd(k, 2);
+    check(c.totalSpace() == space && c.length(2) == 4 && c.getLast(2)->obj == 3, "cleared entries are reused");
+
+    // Storage grows geometrically, with new entries pushed on the free list
+    Lists<double> g;
+    g.alloc(0, 2);
+    g.setGrowth(1.5f);
+    int nGrow = 0, last = g.totalSpace();
+    for (int k = 0; k < 10000; ++k) {
+        g.insert(k, k & 1);
+        if (g.totalSpace() != last) { nGrow++; last = g.totalSpace(); }
+    }
+    check(g.numEntries() == 10000 && g.length(0) == 5000 && nGrow < 20, "geometric growth");
+    check(g.reserve(20000) && g.totalSpace() == 20000, "reserve");
+    for (int k = 0; k < 10000; ++k) g.insertAtEnd(k, 0);
+    ok = g.totalSpace() == 20000 && g.length(0) == 15000 && g.getLast(0)->obj == 9999;
+    check(ok, "no growth after reserve");
+    Lists<double> e;
+    check(e.reserve(4) && e.totalSpace() >= 4, "reserve without alloc");
+
+    // Compaction lays each list out contiguously, in order
+    Lists<double> f, fa;
+    f.alloc(16, 64);
+    fa.alloc(16, 64);
+    fa.setAutoCompact(0.5f);
+    for (int k = 0; k < 64 * 200; ++k) {
+        f.insertAtEnd(k, k % 64);
+        fa.insertAtEnd(k, k % 64);
+    }
+    for (int k = 0; k < 64 * 200; k += 3) {
+        f.remove(k, k % 64);
+        fa.remove(k, k % 64);
+    }
+    for (int k = 0; k < 64 * 200; k += 3) {
+        f.insert(k, k % 64);
+        fa.insert(k, k % 64);
+    }
+    float before = f.fragmentation();
+    ok = fa.fragmentation() < before;
+    for (int i = 0; i < 64; ++i) {
+        Lists<double>::LinkNext* o = f.getList(i);
+        for (Lists<double>::LinkNext* q = fa.getList(i); q; q = fa.getNext(*q), o = f.getNext(*o))
+            ok = ok && o && o->obj == q->obj;
+    }
+    check(before > 0.9f && ok, "auto-compaction keeps the lists");
+    double sumBefore = 0, sumAfter = 0;
+    for (int i = 0; i < 64; ++i)
+        for (Lists<double>::LinkNext* o = f.getList(i); o; o = f.getNext(*o)) sumBefore += o->obj * (i + 1);
+    check(f.compact() && f.fragmentation() == 0.0f && f.numEntries() == 64 * 200, "compact");
+    ok = true;
+    for (int i = 0; i < 64; ++i) {
+        for (Lists<double>::LinkNext* o = f.getList(i); o; o = f.getNext(*o)) sumAfter += o->obj * (i + 1);
+        ok = ok && f.length(i) == 200 && f.getLast(i) - f.getList(i) == 199;
+    }
+    check(ok && sumBefore == sumAfter, "compacted lists are contiguous and in order");
+    check(f.insertAtEnd(-1, 5) && f.getLast(5)->obj == -1 && f.length(5) == 201, "insert after compact");
+
+    // Split storage (links apart from objects), walked with the cursor API
+    Lists<double, ListsSoA> sl;
+    sl.alloc(4, 3);
+    for (int k = 0; k < 30; ++k) sl.insertAtEnd(k, k % 3);
+    sl.remove(3, 0);
+    sl.popList(1);
+    ok = sl.length(0) == 9 && sl.length(1) == 9 && sl.objOf(sl.last(2)) == 29 && sl.locate(27, 0) != 0;
+    double prev = -1;
+    for (int k = sl.first(0); k >= 0; k = sl.nextOf(k)) { ok = ok && sl.objOf(k) > prev && sl.objOf(k) != 3; prev = sl.objOf(k); }
+    check(ok && sl.compact() && sl.fragmentation() == 0.0f && sl.objOf(sl.first(1)) == 4, "ListsSoA");
+
+    Hash<int, int, ListsSoA, HashFunction<int>, MatchFunction<int> > hs(hashInt, matchInt, 64, 61);
+    Hash<int, int, ListsAoS, HashFunction<int>, MatchFunction<int> > ha(hashInt, matchInt, 64, 61);
+    for (int k = 0; k < 500; ++k) {
+        *hs.add(k * 7) = HashEntry<int, int>(k * 7, k);
+        ha.add(k * 7, k);
+    }
+    ok = hs.getNumEntries() == 500 && hs.del(14) && !hs.del(14) && hs.find(14) == 0 && ha.del(14);
+    for (int k = 0; k < 500 && ok; ++k)
+        ok = k == 2 || (*hs[k * 7] == k && *ha.findContent(k * 7) == k);
+    check(ok && hs.find(8) == 0, "Hash over ListsSoA");
+
+    // Chain walks that only compare keys
+    const int NB = 1 << 16;
+    Lists<Big> ba;
+    Lists<Big, ListsSoA> bs;
+    ba.alloc(NB, 64);
+    bs.alloc(NB, 64);
+    for (int k = 0; k < NB; ++k) {
+        Big b;
+        b.key = k;
+        ba.insert(b, (k * 37) & 63);
+        bs.insert(b, (k * 37) & 63);
+    }
+    Big probe;
+    probe.key = -1;
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < 64; ++i) ok = ba.locate(probe, i) == 0;
+    t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < 64; ++i) ok = ok && bs.locate(probe, i) == 0;
+    auto t2 = std::chrono::steady_clock::now();
+    check(ok, "locate a missing key");
+    std::printf("  walk %d entries of %d bytes: AoS %.2f ms, SoA %.2f ms\n", NB, (int)sizeof(Big),
+                std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                std::chrono::duration<double, std::milli>(t2 - t1).count());
+
+    // Unrolled lists: several objects per link hop
+    UnrolledLists<int, 4> ul;
+    ul.alloc(8, 3);
+    for (int k = 0; k < 30; ++k) ul.insertAtEnd(k, k % 3);
+    ul.insert(-3, 0);
+    ok = ul.length(0) == 11 && ul.numEntries() == 31 && ul.locate(27, 0) && !ul.locate(28, 0);
+    for (int k = 0; k < 30; k += 3) ok = ok && ul.remove(k, 0);
+    check(ok && ul.length(0) == 1 && ul.remove(-3, 0) && ul.first(0) < 0, "UnrolledLists insert/remove");
+    int expect = 1;
+    ok = true;
+    ul.forEach(1, [&](int& v) { ok = ok && v == expect; expect += 3; });
+    check(ok && expect == 31, "UnrolledLists order");
+
+    const int NU = 1 << 20;
+    Lists<int> lu;
+    UnrolledLists<int> uu;
+    lu.alloc(NU, 16);
+    uu.alloc(NU, 16);
+    for (int k = 0; k < NU; ++k) {
+        lu.insertAtEnd(k, (k * 7) & 15);
+        uu.insertAtEnd(k, (k * 7) & 15);
+    }
+    long long s1 = 0, s2 = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < 16; ++i)
+        for (int k = lu.first(i); k >= 0; k = lu.nextOf(k)) s1 += lu.objOf(k);
+    t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < 16; ++i) uu.forEach(i, [&](int& v) { s2 += v; });
+    auto t3 = std::chrono::steady_clock::now();
+    check(s1 == s2 && s1 == (long long)NU * (NU - 1) / 2, "UnrolledLists scan");
+    std::printf("  scan %d ints: Lists %.2f ms, UnrolledLists<int,%d> %.2f ms\n", NU,
+                std::chrono::duration<double, std::milli>(t1 - t0).count(), (int)(sizeof(UnrolledLists<int>::Block) / sizeof(int)) - 1,
+                std::chrono::duration<double, std::milli>(t3 - t1).count());
+
+    // Bulk build: lists come out contiguous and in input order
+    const int NBF = 1 << 18, NLB = 1000;
+    Array<int> bobj, bid;
+    bobj.alloc(NBF);
+    bid.alloc(NBF);
+    for (int k = 0; k < NBF; ++k) {
+        bobj[k] = k;
+        bid[k] = (int)(((unsigned)k * 2654435761u >> 7) % NLB);
+    }
+    Lists<int> lb, li;
+    lb.alloc(16, NLB);
+    li.alloc(16, NLB);
+    lb.insert(-5, 3);
+    t0 = std::chrono::steady_clock::now();
+    check(lb.buildFrom(bobj.begin(), bid.begin(), NBF), "buildFrom");
+    t1 = std::chrono::steady_clock::now();
+    for (int k = 0; k < NBF; ++k) li.insertAtEnd(bobj[k], bid[k]);
+    auto t4 = std::chrono::steady_clock::now();
+    ok = lb.numEntries() == NBF && lb.fragmentation() == 0.0f;
+    for (int i = 0; i < NLB; ++i) {
+        int k2 = li.first(i);
+        for (int k = lb.first(i); k >= 0; k = lb.nextOf(k), k2 = li.nextOf(k2)) ok = ok && k2 >= 0 && lb.objOf(k) == li.objOf(k2);
+        ok = ok && k2 < 0 && lb.length(i) == li.length(i) && lb.objOf(lb.last(i)) == li.objOf(li.last(i));
+    }
+    check(ok, "buildFrom matches appending one by one");
+    setNumThreads(4);
+    Lists<int> lp;
+    lp.alloc(0, NLB);
+    ok = lp.buildFrom(bobj.begin(), bid.begin(), NBF);
+    setNumThreads(0);
+    for (int i = 0; i < NLB; ++i) {
+        int k2 = li.first(i);
+        for (int k = lp.first(i); k >= 0; k = lp.nextOf(k), k2 = li.nextOf(k2)) ok = ok && k2 >= 0 && lp.objOf(k) == li.objOf(k2);
+        ok = ok && k2 < 0;
+    }
+    check(ok, "buildFrom on 4 threads");
+    check(lb.insert(7, 3) && lb.length(3) == li.length(3) + 1 && lb.objOf(lb.first(3)) == 7, "insert after buildFrom");
+    bid[5] = NLB;
+    check(!lb.buildFrom(bobj.begin(), bid.begin(), NBF), "buildFrom checks the list ids");
+    std::printf("  %d objects into %d lists: buildFrom %.2f ms, insertAtEnd %.2f ms\n", NBF, NLB,
+                std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                std::chrono::duration<double, std::milli>(t4 - t1).count());
+
+    // Doubly-linked mode: O(1) unlink, moveToFront and insertAfter by handle,
+    // checked against std::list with random operations
+    Lists<int> dl;
+    dl.alloc(4, 4);
+    dl.insertAtEnd(-1, 2);
+    dl.setDoublyLinked(true);
+    std::list<int> ref[4];
+    ref[2].push_back(-1);
+    std::vector<int> handle(1, dl.first(2)), where(1, 2), alive(1, 1);
+    unsigned seed = 12345;
+    ok = dl.isDoublyLinked() && dl.prevOf(dl.first(2)) == -1 && dl.listOf(dl.first(2)) == 2;
+    for (int step = 0; step < 20000 && ok; ++step) {
+        seed = seed * 1103515245u + 12345u;
+        int op = (seed >> 16) % 6, v = (int)handle.size(), h = -1, id = -1;
+        for (int tries = 0; tries < 8 && id < 0; ++tries) {
+            seed = seed * 1103515245u + 12345u;
+            int c = (int)((seed >> 8) % handle.size());
+            if (alive[c]) { id = c; h = handle[c]; }
+        }
+        int i = (seed >> 4) & 3;
+        if (op <= 1 || id < 0) {
+            (op & 1) ? dl.insert(v, i) : dl.insertAtEnd(v, i);
+            (op & 1) ? ref[i].push_front(v) : ref[i].push_back(v);
+            handle.push_back((op & 1) ? dl.first(i) : dl.last(i));
+            where.push_back(i);
+            alive.push_back(1);
+        } else if (op == 2) {
+            dl.unlink(h);
+            ref[where[id]].remove(id < 1 ? -1 : id);
+            alive[id] = 0;
+        } else if (op == 3) {
+            dl.moveToFront(h);
+            int val = id < 1 ? -1 : id;
+            ref[where[id]].remove(val);
+            ref[where[id]].push_front(val);
+        } else if (op == 4) {
+            int k = dl.insertAfter(h, v);
+            std::list<int>& r = ref[where[id]];
+            for (std::list<int>::iterator it = r.begin(); it != r.end(); ++it)
+                if (*it == (id < 1 ? -1 : id)) { r.insert(++it, v); break; }
+            handle.push_back(k);
+            where.push_back(where[id]);
+            alive.push_back(1);
+        } else {
+            dl.popList(i);
+            if (!ref[i].empty()) {
+                int val = ref[i].front();
+                ref[i].pop_front();
+                alive[val < 0 ? 0 : val] = 0;
+            }
+        }
+        if (step % 97 == 0 || step == 19999)
+            for (int l = 0; l < 4; ++l) {
+                std::list<int>::iterator it = ref[l].begin();
+                int p = -1;
+                for (int k = dl.first(l); k >= 0; p = k, k = dl.nextOf(k), ++it)
+                    ok = ok && it != ref[l].end() && dl.objOf(k) == *it && dl.prevOf(k) == p && dl.listOf(k) == l;
+                ok = ok && it == ref[l].end() && dl.last(l) == p && dl.length(l) == (int)ref[l].size();
+            }
+    }
+    check(ok, "doubly-linked operations match std::list");
+    check(dl.compact() && dl.prevOf(dl.last(1)) == (dl.length(1) > 1 ? dl.last(1) - 1 : -1), "prev links rebuilt by compact");
+
+    // Fixed capacity, no heap
+    ListsCache<4, double, 8> lc;
+    ok = lc.totalSpace() == 8 && lc.numLists() == 4;
+    for (int k = 0; k < 8; ++k) ok = ok && (k & 1 ? lc.insert(k, k % 4) : lc.insertAtEnd(k, k % 4));
+    check(ok && !lc.insert(8, 0) && lc.insertAtEnd(0) == 0 && lc.numEntries() == 8, "ListsCache full");
+    ok = lc.length(1) == 2 && lc.objOf(lc.first(1)) == 5 && lc.getLast(1)->obj == 1 && lc.locate(4, 0);
+    check(ok && lc.remove(4, 0) && !lc.remove(4, 0) && lc.getLast(0)->obj == 0, "ListsCache remove");
+    lc.popList(3);
+    lc.popNext(*lc.getList(2), 2);
+    lc.clearList(1);
+    check(lc.numEntries() == 3 && lc.length(1) == 0 && lc.getList(1) == 0 && lc.getLast(3)->obj == 3, "ListsCache pops");
+    for (int k = 0; k < 5; ++k) ok = ok && lc.insertAtEnd(10 + k, 1);
+    check(ok && !lc.insert(0.5, 2) && lc.length(1) == 5 && lc.getLast(1)->obj == 14, "ListsCache reuses freed entries");
+
+    // Building long lists by appending is linear
+    const int N = 200000;
+    Lists<double> big;
+    big.alloc(16, 8);
+    t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < N; ++k) big.insertAtEnd(k, k % 8);
+    t1 = std::chrono::steady_clock::now();
+    ok = true;
+    for (int i = 0; i < 8; ++i) {
+        int expect = i;
+        for (Lists<double>::LinkNext* o = big.getList(i); o; o = big.getNext(*o), expect += 8) ok = ok && o->obj == expect;
+        ok = ok && expect - 8 == big.getLast(i)->obj;
+    }
+    check(ok, "long lists appended in order");
+    std::printf("  %d appends: %.1f ms\n", N, std::chrono::duration<double, std::milli>(t1 - t0).count());
+
+    return nFail == 0 ? 0 : 1;
+}
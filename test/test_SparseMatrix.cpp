@@ -0,0 +1,68 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <DSA/SparseMatrix.h>
+#include "TestCheck.h"
+using namespace DSA;
+
+int main() {
+    std::printf("Test CSRMatrix<int> from triplets \n");
+    int ti[] = {2, 0, 2, 1, 2};
+    int tj[] = {3, 1, 0, 1, 3};
+    int tv[] = {5, 1, 7, 2, 1};
+    CSRMatrix<int> a;
+    check(a.build(3, 4, ti, tj, tv, 5), "build from triplets");
+    check(a.nnz() == 4 && a(2, 3) == 6 && a(2, 0) == 7 && a(0, 0) == 0, "duplicates summed");
+    check(a.idx()[a.ptr()[2]] == 0 && a.idx()[a.ptr()[2] + 1] == 3, "columns sorted in a row");
+
+    Array2D<int> d;
+    a.toDense(d);
+    CSCMatrix<int> c;
+    c.build(d);
+    CSRMatrix<int> back;
+    back.build(c);
+    check(c(2, 3) == 6 && back(1, 1) == 2 && back.nnz() == 4, "dense and CSC round trip");
+
+    std::printf("Test parallel SpMV/SpMM \n");
+    setNumThreads(4);
+    const int n = 3000;
+    Array2D<double> m(n, n);
+    m = 0.0;
+    for (int i = 0; i < n; ++i)
+        for (int k = 0; k < 30; ++k)
+            m[i][(i * 7 + k * 97) % n] = 1.0 + (i % 5) + k;
+    CSRMatrix<double> s;
+    CSCMatrix<double> sc;
+    s.build(m);
+    sc.build(s);
+    Array<double> x(n), y, yc;
+    for (int j = 0; j < n; ++j) x[j] = 1.0 / (1 + j % 13);
+    s.multiply(x, y);
+    sc.multiply(x, yc);
+    bool ok = y.len() == n;
+    for (int i = 0; i < n; ++i) {
+        double ref = 0;
+        for (int j = 0; j < n; ++j) ref += m[i][j] * x[j];
+        ok = ok && std::fabs(ref - y[i]) < 1e-9 && std::fabs(ref - yc[i]) < 1e-9;
+    }
+    check(ok, "SpMV matches dense (CSR and CSC)");
+
+    Array2D<double> X(n, 3), Y, Yc;
+    for (int j = 0; j < n; ++j)
+        for (int c2 = 0; c2 < 3; ++c2) X[j][c2] = x[j] * (c2 + 1);
+    s.multiply(X, Y);
+    sc.multiply(X, Yc);
+    ok = Y.rows() == n && Y.cols() == 3;
+    for (int i = 0; i < n; ++i)
+        for (int c2 = 0; c2 < 3; ++c2)
+            ok = ok && std::fabs(Y[i][c2] - y[i] * (c2 + 1)) < 1e-9 && std::fabs(Yc[i][c2] - Y[i][c2]) < 1e-9;
+    check(ok, "SpMM matches SpMV");
+
+    CSRView<double> v = s.slice(100, 200);
+    Array<double> yv;
+    v.multiply(x, yv);
+    check(v.rows == 100 && yv.len() == 100 && yv[5] == y[105], "row slice view");
+
+    std::cout << "CSR nnz=" << s.nnz() << " of " << n * n << std::endl;
+    return nFail == 0 ? 0 : 1;
+}
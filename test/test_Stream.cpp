@@ -0,0 +1,114 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdint>
+#include <DSA/Array.h>
+#include <DSA/Array2D.h>
+#include <DSA/ArrayND.h>
+#include "TestCheck.h"
+using namespace DSA;
+
+int main() {
+    std::printf("Test Stream put/get of Array, Array2D and ArrayND \n");
+    Array<int> a;
+    for (int i = 0; i < 100; ++i) a.append(i * 3);
+    Array2D<double> m(37, 45);
+    for (int i = 0; i < m.rows(); ++i)
+        for (int j = 0; j < m.cols(); ++j) m[i][j] = i * 1000.0 + j;
+    ArrayND<float, 3> c(4, 5, 6);
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 5; ++j)
+            for (int k = 0; k < 6; ++k) c(i, j, k) = i * 100.f + j * 10.f + k;
+    Array2D<int, 2, 70> s; // Rows wide enough to be padded once read back
+    for (int i = 0; i < 140; ++i) s.begin()[i] = i + 1;
+
+    Stream mem;
+    check(mem.put(a) && mem.put(m) && mem.put(c) && mem.put(s), "put to memory");
+    mem.rewind();
+    Array<int> a2;
+    Array2D<double> m2;
+    ArrayND<float, 3> c2;
+    Array2D<int> s2;
+    check(mem.get(a2) && a2.len() == 100 && a2[99] == 297, "Array round trip");
+    check(mem.get(m2) && m2.rows() == 37 && m2.cols() == 45 && m2[36][44] == 36044 && m2[5][0] == 5000, "Array2D round trip");
+    check(mem.get(c2) && c2.d1() == 4 && c2.d3() == 6 && c2(3, 4, 5) == 345, "ArrayND round trip");
+    check(mem.get(s2) && s2.rows() == 2 && s2.cols() == 70 && s2[1][69] == 140 && s2.ld() != 70, "static Array2D into a strided one");
+
+    mem.rewind();
+    Array2D<float> wrong;
+    check(!mem.get(wrong), "element type is checked");
+    mem.seek(0);
+    Array2D<double> view;
+    mem.get(a2);
+    check(view.map(mem) && view.begin() != m2.begin() && view[36][44] == 36044
+          && (const UChar*)view.begin() >= mem.data() && (const UChar*)view.begin() < mem.data() + mem.size()
+          && ((uintptr_t)view.begin()) % CacheLine == 0, "map from memory, in place");
+
+    // The storage order is part of the record
+    Stream zs;
+    ArrayND<int, 2, MortonIndexer> z(8, 8);
+    for (int i = 0; i < 8; ++i)
+        for (int j = 0; j < 8; ++j) z(i, j) = i * 10 + j;
+    ArrayND<int, 2> zr;
+    ArrayND<int, 2, MortonIndexer> z2;
+    check(zs.put(z) && !zs.get(zr), "a Morton array does not read back as row-major");
+    zs.rewind();
+    check(zs.get(z2) && z2(7, 3) == 73 && z2(2, 6) == 26, "Morton round trip");
+
+    Array2D<float, 0, 0, TileIndexer> tl(20, 37);
+    for (int i = 0; i < 20; ++i)
+        for (int j = 0; j < 37; ++j) tl(i, j) = i * 100.f + j;
+    Array2D<float, 0, 0, TileIndexer> tl2;
+    Array2D<float, 0, 0, MortonIndexer> tz;
+    zs.rewind();
+    check(zs.put(tl) && zs.seek(0) && !zs.get(tz) && zs.seek(0) && zs.get(tl2)
+          && tl2.rows() == 20 && tl2.cols() == 37 && tl2(19, 36) == 1936.f && tl2(8, 0) == 800.f, "tiled Array2D round trip");
+
+    // Corrupt headers are rejected before anything is allocated or changed
+    Stream bad;
+    Array<int> bi;
+    bi.resize(4);
+    check(bad.put(bi), "put a small Array");
+    ArrayHeader* bh = (ArrayHeader*)bad.data();
+    bh->count = 0x100000004ull;
+    bad.rewind();
+    check(!bad.get(bi) && bad.seek(0) && !bad.map(bi), "count above INT_MAX");
+    Stream badND;
+    ArrayND<float, 3> nd(2, 3, 4), nd2(4, 5, 6);
+    check(badND.put(nd), "put a small ArrayND");
+    ((ArrayHeader*)badND.data())->dims[0] = 3;
+    badND.rewind();
+    check(!badND.get(nd2) && nd2.d1() == 4 && nd2.d2() == 5 && nd2.d3() == 6, "rejected dimensions leave the array alone");
+
+    std::printf("Test Stream file and mapped I/O \n");
+    const char* path = "test_Stream.bin";
+    {
+        Stream f;
+        check(f.open(path, Stream::Write) && f.put(a) && f.put(m) && f.put(c), "put to file");
+    }
+    {
+        Stream f;
+        Array<int> fa;
+        Array2D<double> fm;
+        ArrayND<float, 3> fc;
+        check(f.open(path, Stream::Read) && f.get(fa) && fa[50] == 150, "get Array from file");
+        check(f.map(fm) && fm[20][30] == 20030, "map from a file stream copies");
+        check(f.get(fc) && fc(1, 2, 3) == 123, "get ArrayND from file");
+    }
+    {
+        Stream f;
+        Array<int> fa;
+        Array2D<double> fm;
+        ArrayND<float, 3> fc;
+        check(f.open(path, Stream::Mapped) && f.map(fa) && f.map(fm) && f.map(fc), "map from a mapped file");
+        check(fa[99] == 297 && fm[36][44] == 36044 && fc(3, 4, 5) == 345, "mapped contents");
+        check((const UChar*)fm.begin() > f.data() && ((uintptr_t)fm.begin()) % CacheLine == 0, "mapped in place");
+        fm[0][0] = -1;                              // copy-on-write page
+        fm.resize(40, 45);                          // grows out of the mapping
+        check(fm[0][0] == -1 && fm[36][44] == 36044 && fm[39][0] == 0, "resize a mapped array");
+    }
+    std::remove(path);
+
+    std::cout << "Array2D record: " << sizeof(ArrayHeader) << " byte header + "
+              << m.rows() * m.ld() * sizeof(double) << " byte payload" << std::endl;
+    return nFail == 0 ? 0 : 1;
+}